@@ -0,0 +1,305 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * avl_tree.c :
+              = the implementation of the module `avl_tree` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include "avl_tree.h"
+
+/* some 'private' helper functions */
+static int height(avl_node_t *node);
+static void update_height(avl_node_t *node);
+static avl_node_t *rotate_left(avl_node_t *node);
+static avl_node_t *rotate_right(avl_node_t *node);
+static avl_node_t *rebalance(avl_node_t *node);
+static avl_node_t *insert_node(avl_node_t *root, avl_node_t *new);
+static avl_node_t *delete_node(avl_node_t *root, avl_key_t key,
+        avl_node_t **deleted);
+static avl_node_t *detach_min(avl_node_t *root, avl_node_t **min);
+static void free_subtree(avl_node_t *root);
+
+
+/* Creates and returns an empty tree.
+ */
+avl_tree_t *make_empty_avl() {
+    avl_tree_t *tree = malloc(sizeof(*tree));
+    assert(tree);
+    tree->root = NULL;
+    tree->count = 0;
+    tree->visits = 0;
+    return tree;
+}
+
+/* Returns TRUE (1) if the tree is empty, FALSE (0) otherwise.
+ */
+int is_empty_avl(avl_tree_t *tree) {
+    assert(tree);
+    return tree->root == NULL;
+}
+
+/* Returns a key made of the two given values.
+ */
+avl_key_t make_avl_key(int64_t primary, int64_t secondary) {
+    avl_key_t key = {primary, secondary};
+    return key;
+}
+
+/* Compares two keys.
+ * Returns negative if `k1` orders first, positive if `k2` orders first,
+   0 otherwise.
+ */
+int cmp_avl_key(avl_key_t k1, avl_key_t k2) {
+    if (k1.primary < k2.primary) return -1;
+    if (k1.primary > k2.primary) return 1;
+    if (k1.secondary < k2.secondary) return -1;
+    if (k1.secondary > k2.secondary) return 1;
+    return 0;
+}
+
+/* Helper function to return the height of the (possibly empty) subtree.
+ */
+static int height(avl_node_t *node) {
+    return node ? node->height : 0;
+}
+
+/* Helper function to recompute the height of the node from its children.
+ */
+static void update_height(avl_node_t *node) {
+    int left = height(node->left), right = height(node->right);
+    node->height = 1 + (left > right ? left : right);
+}
+
+/* Helper function to rotate the subtree left, and return its new root.
+ */
+static avl_node_t *rotate_left(avl_node_t *node) {
+    avl_node_t *new_root = node->right;
+    node->right = new_root->left;
+    new_root->left = node;
+    update_height(node);
+    update_height(new_root);
+    return new_root;
+}
+
+/* Helper function to rotate the subtree right, and return its new root.
+ */
+static avl_node_t *rotate_right(avl_node_t *node) {
+    avl_node_t *new_root = node->left;
+    node->left = new_root->right;
+    new_root->right = node;
+    update_height(node);
+    update_height(new_root);
+    return new_root;
+}
+
+/* Helper function to restore the balance of the subtree rooted at the node
+   (whose children are balanced), and return its new root.
+ */
+static avl_node_t *rebalance(avl_node_t *node) {
+    update_height(node);
+    int balance = height(node->left) - height(node->right);
+
+    if (balance > 1) { // left-heavy
+        if (height(node->left->left) < height(node->left->right))
+            node->left = rotate_left(node->left);
+        return rotate_right(node);
+    }
+    if (balance < -1) { // right-heavy
+        if (height(node->right->right) < height(node->right->left))
+            node->right = rotate_right(node->right);
+        return rotate_left(node);
+    }
+    return node;
+}
+
+/* Helper function to insert the node into the subtree,
+   and return the new root of the subtree.
+ */
+static avl_node_t *insert_node(avl_node_t *root, avl_node_t *new) {
+    if (!root)
+        return new;
+
+    int cmp = cmp_avl_key(new->key, root->key);
+    assert(cmp != 0); // keys must be unique
+    if (cmp < 0)
+        root->left = insert_node(root->left, new);
+    else
+        root->right = insert_node(root->right, new);
+
+    return rebalance(root);
+}
+
+/* Inserts the data under the (unique) key into the tree.
+ */
+void avl_insert(avl_tree_t *tree, avl_key_t key, void *data) {
+    assert(tree);
+    avl_node_t *new = malloc(sizeof(*new));
+    assert(new);
+    new->key = key;
+    new->data = data;
+    new->left = new->right = NULL;
+    new->height = 1;
+
+    tree->root = insert_node(tree->root, new);
+    tree->count++;
+}
+
+/* Helper function to detach the node with the smallest key in the subtree
+   (stored in `min`), and return the new root of the subtree.
+ */
+static avl_node_t *detach_min(avl_node_t *root, avl_node_t **min) {
+    if (!root->left) {
+        *min = root;
+        return root->right;
+    }
+    root->left = detach_min(root->left, min);
+    return rebalance(root);
+}
+
+/* Helper function to detach the node with the key from the subtree
+   (stored in `deleted`), and return the new root of the subtree.
+ */
+static avl_node_t *delete_node(avl_node_t *root, avl_key_t key,
+        avl_node_t **deleted) {
+    if (!root) // key not found
+        return NULL;
+
+    int cmp = cmp_avl_key(key, root->key);
+    if (cmp < 0) {
+        root->left = delete_node(root->left, key, deleted);
+    } else if (cmp > 0) {
+        root->right = delete_node(root->right, key, deleted);
+    } else {
+        *deleted = root;
+        if (!root->left)
+            return root->right;
+        if (!root->right)
+            return root->left;
+
+        // replace the node by its in-order successor
+        avl_node_t *successor;
+        avl_node_t *right = detach_min(root->right, &successor);
+        successor->left = root->left;
+        successor->right = right;
+        return rebalance(successor);
+    }
+
+    return rebalance(root);
+}
+
+/* Deletes the node with the key from the tree, and returns its data.
+ * Returns NULL if no such node exists.
+ */
+void *avl_delete(avl_tree_t *tree, avl_key_t key) {
+    assert(tree);
+    avl_node_t *deleted = NULL;
+    tree->root = delete_node(tree->root, key, &deleted);
+    if (!deleted)
+        return NULL;
+
+    void *data = deleted->data;
+    free(deleted);
+    deleted = NULL;
+    tree->count--;
+    return data;
+}
+
+/* Returns the node with the key, or NULL if no such node exists.
+ */
+avl_node_t *avl_find(avl_tree_t *tree, avl_key_t key) {
+    assert(tree);
+    avl_node_t *curr = tree->root;
+    int cmp;
+    while (curr) {
+        tree->visits++;
+        if ((cmp = cmp_avl_key(key, curr->key)) == 0)
+            break;
+        curr = cmp < 0 ? curr->left : curr->right;
+    }
+    return curr;
+}
+
+/* Returns the node with the smallest key >= `key`,
+   or NULL if no such node exists.
+ */
+avl_node_t *avl_lower_bound(avl_tree_t *tree, avl_key_t key) {
+    assert(tree);
+    avl_node_t *curr = tree->root;
+    avl_node_t *bound = NULL;
+    while (curr) {
+        tree->visits++;
+        if (cmp_avl_key(curr->key, key) >= 0) {
+            // candidate; look for a smaller one on the left
+            bound = curr;
+            curr = curr->left;
+        } else {
+            curr = curr->right;
+        }
+    }
+    return bound;
+}
+
+/* Returns the node with the largest key <= `key`,
+   or NULL if no such node exists.
+ */
+avl_node_t *avl_floor(avl_tree_t *tree, avl_key_t key) {
+    assert(tree);
+    avl_node_t *curr = tree->root;
+    avl_node_t *bound = NULL;
+    while (curr) {
+        tree->visits++;
+        if (cmp_avl_key(curr->key, key) <= 0) {
+            // candidate; look for a larger one on the right
+            bound = curr;
+            curr = curr->right;
+        } else {
+            curr = curr->left;
+        }
+    }
+    return bound;
+}
+
+/* Returns the node with the smallest key, or NULL if the tree is empty.
+ */
+avl_node_t *avl_min(avl_tree_t *tree) {
+    assert(tree);
+    avl_node_t *curr = tree->root;
+    while (curr && curr->left) {
+        tree->visits++;
+        curr = curr->left;
+    }
+    return curr;
+}
+
+/* Returns the node with the largest key, or NULL if the tree is empty.
+ */
+avl_node_t *avl_max(avl_tree_t *tree) {
+    assert(tree);
+    avl_node_t *curr = tree->root;
+    while (curr && curr->right) {
+        tree->visits++;
+        curr = curr->right;
+    }
+    return curr;
+}
+
+/* Helper function to free all nodes in the subtree.
+ */
+static void free_subtree(avl_node_t *root) {
+    if (!root)
+        return;
+    free_subtree(root->left);
+    free_subtree(root->right);
+    free(root);
+}
+
+/* Frees all memory allocated to the tree (but not the data held).
+ */
+void free_avl(avl_tree_t *tree) {
+    assert(tree);
+    free_subtree(tree->root);
+    tree->root = NULL;
+    free(tree);
+    tree = NULL;
+}
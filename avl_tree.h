@@ -0,0 +1,93 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * avl_tree.h :
+              = the interface of the module `avl_tree` of the project
+              = provides a polymorphic balanced (AVL) binary search tree,
+                ordered by a pair of integer keys
+ ----------------------------------------------------------------------------*/
+
+#ifndef _AVL_TREE_H_
+#define _AVL_TREE_H_
+
+#include <stdint.h>
+
+/* ordering key of a tree node: compared by `primary`, then `secondary` */
+typedef struct {
+    int64_t primary;
+    int64_t secondary;
+} avl_key_t;
+
+typedef struct avl_node avl_node_t;
+
+struct avl_node {
+    avl_key_t key;
+    void *data;
+    avl_node_t *left;
+    avl_node_t *right;
+    int height;       // height of the subtree rooted at this node
+};
+
+typedef struct {
+    avl_node_t *root;
+    int count;        // number of nodes in the tree
+    long visits;      // number of nodes visited by searches so far
+} avl_tree_t;
+
+
+/************** function declarations **************/
+
+/* Creates and returns an empty tree.
+ */
+avl_tree_t *make_empty_avl();
+
+/* Returns TRUE (1) if the tree is empty, FALSE (0) otherwise.
+ */
+int is_empty_avl(avl_tree_t *tree);
+
+/* Returns a key made of the two given values.
+ */
+avl_key_t make_avl_key(int64_t primary, int64_t secondary);
+
+/* Compares two keys.
+ * Returns negative if `k1` orders first, positive if `k2` orders first,
+   0 otherwise.
+ */
+int cmp_avl_key(avl_key_t k1, avl_key_t k2);
+
+/* Inserts the data under the (unique) key into the tree.
+ */
+void avl_insert(avl_tree_t *tree, avl_key_t key, void *data);
+
+/* Deletes the node with the key from the tree, and returns its data.
+ * Returns NULL if no such node exists.
+ */
+void *avl_delete(avl_tree_t *tree, avl_key_t key);
+
+/* Returns the node with the key, or NULL if no such node exists.
+ */
+avl_node_t *avl_find(avl_tree_t *tree, avl_key_t key);
+
+/* Returns the node with the smallest key >= `key`,
+   or NULL if no such node exists.
+ */
+avl_node_t *avl_lower_bound(avl_tree_t *tree, avl_key_t key);
+
+/* Returns the node with the largest key <= `key`,
+   or NULL if no such node exists.
+ */
+avl_node_t *avl_floor(avl_tree_t *tree, avl_key_t key);
+
+/* Returns the node with the smallest key, or NULL if the tree is empty.
+ */
+avl_node_t *avl_min(avl_tree_t *tree);
+
+/* Returns the node with the largest key, or NULL if the tree is empty.
+ */
+avl_node_t *avl_max(avl_tree_t *tree);
+
+/* Frees all memory allocated to the tree (but not the data held).
+ */
+void free_avl(avl_tree_t *tree);
+
+
+#endif
@@ -0,0 +1,345 @@
+/*-----------------------------------------------------------------------------
+ * Project 1: Process Management
+ * bench.c :
+              = the allocator benchmark of the project
+ *
+ * Drives the memory allocators directly (without processes or the
+   scheduler) with a sequence of allocations and frees, either synthetic
+   or replayed from a trace, and reports for each memory strategy the
+   operations per second (of time spent in the allocator), the median and
+   99th percentile latency of an operation, the peak number of segments 
+   (holes and blocks), and the allocations that failed.
+ *
+ * The executable is named `allocate_bench` (built and run by `make bench`).
+ * Usage:
+   allocate_bench [-m <memory-strategy>] [-n <operations>] [-M <capacity>]
+                  [-l (list | array)] [-s <seed>]
+                  [-r <trace-file>] [-w <trace-file>]
+ *
+ * -m <memory-strategy>: (optional) one of {best-fit, first-fit, next-fit,
+                         worst-fit, buddy, bitmap, tlsf, slab}; all of them
+                         by default.
+ * -n <operations>     : (optional) the number of synthetic operations;
+                         1000000 by default.
+ * -M <capacity>       : (optional) the memory capacity in MB; 2048 by
+                         default.
+ * -l <memory-map>     : (optional) memory-map is one of {list, array};
+                         list by default.
+ * -s <seed>           : (optional) the seed of the synthetic operations.
+ * -r <trace-file>     : (optional) replay the operations in the file
+                         instead, one per line: "a <id> <size>" allocates
+                         `size` MB to `id`, and "f <id>" frees it.
+ * -w <trace-file>     : (optional) write the operations to the file
+                         (in the format read by -r).
+ ----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <time.h>
+#include "memory.h"
+
+#define DEFAULT_OPERATIONS 1000000
+#define DEFAULT_SEED 1
+
+#define ALLOC_OP 'a'
+#define FREE_OP 'f'
+
+#define NUM_COMMON_SIZES 8   // sizes that recur in the synthetic operations
+#define FILL_TARGET 0.9      // share of memory the synthetic operations fill
+
+/* an operation on memory */
+typedef struct {
+    char type;          // ALLOC_OP or FREE_OP
+    int id;             // of the allocation
+    mem_addr_t size;    // of an allocation
+} operation_t;
+
+/* a memory strategy, as benchmarked */
+typedef struct {
+    const char *name;
+    enum memory_allocator allocator;
+    process_allocator_fp_t allocate;
+    void (*enable)(memory_t *);  // the index it needs, or NULL
+} strategy_t;
+
+const strategy_t strategies[] = {
+    {"best-fit", SEGMENT_ALLOCATOR, malloc_by_best_fit, NULL},
+    {"first-fit", SEGMENT_ALLOCATOR, malloc_by_first_fit, enable_hole_array},
+    {"next-fit", SEGMENT_ALLOCATOR, malloc_by_next_fit, enable_hole_array},
+    {"worst-fit", SEGMENT_ALLOCATOR, malloc_by_worst_fit, NULL},
+    {"buddy", BUDDY_ALLOCATOR, malloc_by_buddy, NULL},
+    {"bitmap", BITMAP_ALLOCATOR, malloc_by_bitmap, NULL},
+    {"tlsf", SEGMENT_ALLOCATOR, malloc_by_tlsf, enable_tlsf},
+    {"slab", SEGMENT_ALLOCATOR, malloc_by_slab, enable_slab},
+};
+#define NUM_STRATEGIES (int) (sizeof(strategies) / sizeof(*strategies))
+
+operation_t *synthesize(long count, mem_addr_t capacity, unsigned seed,
+        int *num_ids);
+operation_t *read_trace(char *filename, long *count, int *num_ids);
+void write_trace(char *filename, operation_t *ops, long count);
+void run_benchmark(const strategy_t *strategy, enum map_type map_type,
+        mem_addr_t capacity, operation_t *ops, long count, int num_ids);
+int64_t count_segments(memory_t *memory, int live);
+int cmp_latency(const void *l1, const void *l2);
+int64_t elapsed_ns(struct timespec *start, struct timespec *end);
+
+
+int main(int argc, char **argv) {
+    char *strategy = NULL, *trace = NULL, *output = NULL;
+    char *memory_map = "list";
+    long count = DEFAULT_OPERATIONS;
+    mem_addr_t capacity = DEFAULT_MEMORY_CAPACITY;
+    unsigned seed = DEFAULT_SEED;
+
+    int c;
+    while ((c = getopt(argc, argv, "m:n:M:l:s:r:w:")) != -1) {
+        switch (c) {
+            case 'm': strategy = optarg; break;
+            case 'n': count = atol(optarg); break;
+            case 'M': capacity = atoll(optarg); break;
+            case 'l': memory_map = optarg; break;
+            case 's': seed = atoi(optarg); break;
+            case 'r': trace = optarg; break;
+            case 'w': output = optarg; break;
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+    if (count <= 0 || capacity <= 0) {
+        perror("Invalid number of operations or capacity");
+        exit(EXIT_FAILURE);
+    }
+    enum map_type map_type = strcmp(memory_map, "array") == 0 ?
+            ARRAY_MAP : LIST_MAP;
+    int found = !strategy;
+    for (int i = 0; i < NUM_STRATEGIES && !found; i++)
+        found = strcmp(strategy, strategies[i].name) == 0;
+    if (!found) {
+        perror("Invalid memory strategy");
+        exit(EXIT_FAILURE);
+    }
+
+    int num_ids;
+    operation_t *ops = trace ? read_trace(trace, &count, &num_ids)
+            : synthesize(count, capacity, seed, &num_ids);
+    if (output)
+        write_trace(output, ops, count);
+
+    printf("%-10s %10s %12s %8s %8s %10s %10s\n", "strategy", "ops",
+            "ops/sec", "p50(ns)", "p99(ns)", "segments", "failures");
+    for (int i = 0; i < NUM_STRATEGIES; i++) {
+        if (!strategy || strcmp(strategy, strategies[i].name) == 0)
+            run_benchmark(&strategies[i], map_type, capacity, ops, count,
+                    num_ids);
+    }
+
+    free(ops);
+    ops = NULL;
+    return 0;
+}
+
+/* Generates and returns `count` operations: allocations of recurring or
+   random sizes (up to 1/32 of the capacity), and frees of random live
+   allocations, keeping about FILL_TARGET of the capacity allocated.
+ * Stores the number of allocation ids used in `num_ids`.
+ */
+operation_t *synthesize(long count, mem_addr_t capacity, unsigned seed,
+        int *num_ids) {
+    operation_t *ops = malloc(count * sizeof(*ops));
+    assert(ops);
+    srand(seed);
+    mem_addr_t max_size = capacity / 32 > 0 ? capacity / 32 : 1;
+    mem_addr_t common[NUM_COMMON_SIZES];
+    for (int i = 0; i < NUM_COMMON_SIZES; i++)
+        common[i] = 1 + rand() % max_size;
+
+    // the live allocations' ids, followed by the free ids
+    int max_live = capacity + 1; // sizes are at least 1
+    int *ids = malloc(max_live * sizeof(*ids));
+    mem_addr_t *sizes = malloc(max_live * sizeof(*sizes));
+    assert(ids && sizes);
+    for (int i = 0; i < max_live; i++)
+        ids[i] = i;
+    int live = 0;
+    mem_addr_t allocated = 0;
+    *num_ids = 0;
+
+    for (long i = 0; i < count; i++) {
+        mem_addr_t size = rand() % 2 ? common[rand() % NUM_COMMON_SIZES]
+                : 1 + rand() % max_size;
+        if (live == 0 || (allocated + size <= FILL_TARGET * capacity
+                && rand() % 2)) {
+            int id = ids[live++];
+            sizes[id] = size;
+            allocated += size;
+            ops[i] = (operation_t) {ALLOC_OP, id, size};
+            if (id + 1 > *num_ids)
+                *num_ids = id + 1;
+        } else { // free a random live allocation
+            int victim = rand() % live;
+            int id = ids[victim];
+            ids[victim] = ids[--live];
+            ids[live] = id;
+            allocated -= sizes[id];
+            ops[i] = (operation_t) {FREE_OP, id, 0};
+        }
+    }
+    free(ids);
+    free(sizes);
+    return ops;
+}
+
+/* Reads and returns the operations in the trace file,
+   storing their number in `count`.
+ * Stores the number of allocation ids used in `num_ids`.
+ */
+operation_t *read_trace(char *filename, long *count, int *num_ids) {
+    FILE *f = fopen(filename, "r");
+    if (!f) {
+        perror("Invalid trace file");
+        exit(EXIT_FAILURE);
+    }
+    long size = 1024;
+    operation_t *ops = malloc(size * sizeof(*ops));
+    assert(ops);
+    *count = 0;
+    *num_ids = 0;
+
+    char type;
+    operation_t op;
+    while (fscanf(f, " %c %d", &type, &op.id) == 2) {
+        op.type = type;
+        op.size = 0;
+        if ((type != ALLOC_OP && type != FREE_OP) || op.id < 0
+                || (type == ALLOC_OP
+                    && (fscanf(f, "%" SCN_ADDR, &op.size) != 1
+                        || op.size <= 0))) {
+            perror("Invalid trace operation");
+            exit(EXIT_FAILURE);
+        }
+        if (*count == size) {
+            size *= 2;
+            ops = realloc(ops, size * sizeof(*ops));
+            assert(ops);
+        }
+        ops[(*count)++] = op;
+        if (op.id + 1 > *num_ids)
+            *num_ids = op.id + 1;
+    }
+    fclose(f);
+    return ops;
+}
+
+/* Writes the `count` operations to the file, in the format of a trace.
+ */
+void write_trace(char *filename, operation_t *ops, long count) {
+    FILE *f = fopen(filename, "w");
+    if (!f) {
+        perror("Invalid trace file");
+        exit(EXIT_FAILURE);
+    }
+    for (long i = 0; i < count; i++) {
+        if (ops[i].type == ALLOC_OP)
+            fprintf(f, "%c %d %" PRI_ADDR "\n", ALLOC_OP, ops[i].id,
+                    ops[i].size);
+        else
+            fprintf(f, "%c %d\n", FREE_OP, ops[i].id);
+    }
+    fclose(f);
+}
+
+/* Runs the `count` operations (on allocation ids below `num_ids`) against
+   fresh memory of the capacity, under the strategy, and prints a line of
+   results.
+ * Allocations that fail, and frees of ids holding no memory, still count
+   as operations.
+ */
+void run_benchmark(const strategy_t *strategy, enum map_type map_type,
+        mem_addr_t capacity, operation_t *ops, long count, int num_ids) {
+    memory_t *memory = initialize_memory(strategy->allocator, map_type,
+            capacity);
+    if (strategy->enable)
+        strategy->enable(memory);
+
+    // one stand-in process per allocation id
+    process_t *processes = calloc(num_ids, sizeof(*processes));
+    int64_t *latencies = malloc(count * sizeof(*latencies));
+    assert(processes && latencies);
+    for (int i = 0; i < num_ids; i++)
+        processes[i].address_assigned = NOT_ASSIGNED;
+
+    int live = 0;
+    int64_t peak_segments = count_segments(memory, live), total_ns = 0;
+    struct timespec start, end;
+    for (long i = 0; i < count; i++) {
+        process_t *process = &processes[ops[i].id];
+        if (ops[i].type == ALLOC_OP && process->address_assigned
+                != NOT_ASSIGNED) { // reallocated without a free
+            demalloc(process, memory);
+            process->address_assigned = NOT_ASSIGNED;
+            live--;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (ops[i].type == ALLOC_OP) {
+            process->memory_requirement = ops[i].size;
+            strategy->allocate(memory, process);
+        } else {
+            demalloc(process, memory);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        latencies[i] = elapsed_ns(&start, &end);
+        total_ns += latencies[i];
+
+        if (ops[i].type == FREE_OP) {
+            live -= process->address_assigned != NOT_ASSIGNED;
+            process->address_assigned = NOT_ASSIGNED;
+        } else if (process->address_assigned != NOT_ASSIGNED) {
+            live++;
+            int64_t segments = count_segments(memory, live);
+            if (segments > peak_segments)
+                peak_segments = segments;
+        }
+    }
+
+    qsort(latencies, count, sizeof(*latencies), cmp_latency);
+    printf("%-10s %10ld %12.0lf %8" PRId64 " %8" PRId64 " %10" PRId64
+            " %10ld\n", strategy->name, count,
+            total_ns ? count * 1e9 / total_ns : 0, latencies[count / 2],
+            latencies[count * 99 / 100], peak_segments,
+            memory->num_failures);
+
+    free(latencies);
+    latencies = NULL;
+    free(processes);
+    processes = NULL;
+    free_memory(memory);
+    memory = NULL;
+}
+
+/* Returns the number of segments (holes and blocks) of the memory,
+   holding `live` allocations.
+ */
+int64_t count_segments(memory_t *memory, int live) {
+    if (memory->allocator == SEGMENT_ALLOCATOR)
+        return memory->map->count; // (a slab counts once)
+    return live + count_holes(memory);
+}
+
+/* Compares two latencies for `qsort`.
+ */
+int cmp_latency(const void *l1, const void *l2) {
+    int64_t latency1 = *(const int64_t *) l1, latency2 = *(const int64_t *) l2;
+    return (latency1 > latency2) - (latency1 < latency2);
+}
+
+/* Returns the nanoseconds from `start` to `end`.
+ */
+int64_t elapsed_ns(struct timespec *start, struct timespec *end) {
+    return (int64_t) (end->tv_sec - start->tv_sec) * 1000000000
+            + (end->tv_nsec - start->tv_nsec);
+}
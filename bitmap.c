@@ -0,0 +1,282 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * bitmap.c :
+              = the implementation of the module `bitmap` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include "bitmap.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_AVX2_KERNEL
+#endif
+
+#define FULL_WORD (~(uint64_t) 0)  // a word of used pages
+
+/* some 'private' helper functions */
+static int64_t scan_word(uint64_t word, int64_t base, int64_t n,
+        int64_t *run_start, int64_t *run_len);
+static void mark_pages(bitmap_t *bitmap, int64_t first, int64_t n, int used);
+static void add_run(bitmap_t *bitmap, int64_t first, int64_t n);
+static void remove_run(bitmap_t *bitmap, int64_t first, int64_t n);
+
+
+/* Creates and returns a bitmap over the pages of memory of the given
+   capacity (in MB), initially free.
+ */
+bitmap_t *create_bitmap(mem_addr_t capacity) {
+    assert(capacity > 0);
+    bitmap_t *bitmap = malloc(sizeof(*bitmap));
+    assert(bitmap);
+
+    bitmap->num_pages = capacity / PAGE_SIZE; // a partial page is unusable
+    bitmap->num_words = (bitmap->num_pages + WORD_BITS - 1) / WORD_BITS;
+    bitmap->words = calloc(bitmap->num_words, sizeof(*bitmap->words));
+    assert(bitmap->words || bitmap->num_words == 0);
+
+    // pages past the end of memory are permanently in use
+    int tail = bitmap->num_pages % WORD_BITS;
+    if (tail)
+        bitmap->words[bitmap->num_words-1] = FULL_WORD << tail;
+
+    bitmap->find_free_run = find_free_run_scalar;
+#ifdef HAS_AVX2_KERNEL
+    if (__builtin_cpu_supports("avx2"))
+        bitmap->find_free_run = find_free_run_avx2;
+#endif
+
+    bitmap->runs_by_start = make_empty_avl();
+    bitmap->runs_by_length = make_empty_avl();
+    if (bitmap->num_pages > 0)
+        add_run(bitmap, 0, bitmap->num_pages);
+
+    return bitmap;
+}
+
+/* Returns the number of pages needed to hold the given size (at least one).
+ */
+int64_t pages_needed(mem_addr_t size) {
+    return size > PAGE_SIZE ? (size + PAGE_SIZE - 1) / PAGE_SIZE : 1;
+}
+
+/* Helper function to extend the current run of free pages (starting at
+   `run_start`, `run_len` long) through the word tracking pages from `base`.
+ * Returns the start of the run once it reaches `n` pages, -1 otherwise.
+ */
+static int64_t scan_word(uint64_t word, int64_t base, int64_t n,
+        int64_t *run_start, int64_t *run_len) {
+    if (word == FULL_WORD) { // no free page
+        *run_len = 0;
+        return -1;
+    }
+    if (word == 0) { // all pages free
+        if (*run_len == 0)
+            *run_start = base;
+        *run_len += WORD_BITS;
+        return *run_len >= n ? *run_start : -1;
+    }
+
+    int pos = 0;
+    while (pos < WORD_BITS) {
+        uint64_t rest = word >> pos;
+        if (rest & 1) {
+            // skip the used pages (`~rest` has its top bits set)
+            *run_len = 0;
+            pos += __builtin_ctzll(~rest);
+        } else {
+            int free = rest ? __builtin_ctzll(rest) : WORD_BITS - pos;
+            if (*run_len == 0)
+                *run_start = base + pos;
+            *run_len += free;
+            if (*run_len >= n)
+                return *run_start;
+            pos += free;
+        }
+    }
+    return -1;
+}
+
+/* Returns the index of the first page of the lowest run of `n` free pages,
+   or -1 if there is none.
+ * Scans the bitmap a word (64 pages) at a time.
+ */
+int64_t find_free_run_scalar(bitmap_t *bitmap, int64_t n) {
+    assert(bitmap && n > 0);
+    int64_t run_start = 0, run_len = 0, found;
+
+    for (int64_t w = 0; w < bitmap->num_words; w++) {
+        found = scan_word(bitmap->words[w], w * WORD_BITS, n,
+                &run_start, &run_len);
+        if (found >= 0)
+            return found;
+    }
+    return -1;
+}
+
+#ifdef HAS_AVX2_KERNEL
+/* Same as `find_free_run_scalar`, but skips fully used or fully free
+   stretches of the bitmap 256 pages at a time with AVX2.
+ * Only to be called when the CPU supports AVX2.
+ */
+__attribute__((target("avx2")))
+int64_t find_free_run_avx2(bitmap_t *bitmap, int64_t n) {
+    assert(bitmap && n > 0);
+    const int64_t block_words = 4; // 256 bits
+    const __m256i full = _mm256_set1_epi64x(-1);
+    int64_t run_start = 0, run_len = 0, found;
+    int64_t w = 0;
+
+    for (; w + block_words <= bitmap->num_words; w += block_words) {
+        __m256i block =
+                _mm256_loadu_si256((const __m256i *) &bitmap->words[w]);
+        if (_mm256_testc_si256(block, full)) { // all 256 pages used
+            run_len = 0;
+            continue;
+        }
+        if (_mm256_testz_si256(block, block)) { // all 256 pages free
+            if (run_len == 0)
+                run_start = w * WORD_BITS;
+            run_len += block_words * WORD_BITS;
+            if (run_len >= n)
+                return run_start;
+            continue;
+        }
+        for (int64_t i = w; i < w + block_words; i++) { // mixed block
+            found = scan_word(bitmap->words[i], i * WORD_BITS, n,
+                    &run_start, &run_len);
+            if (found >= 0)
+                return found;
+        }
+    }
+
+    for (; w < bitmap->num_words; w++) { // remaining words
+        found = scan_word(bitmap->words[w], w * WORD_BITS, n,
+                &run_start, &run_len);
+        if (found >= 0)
+            return found;
+    }
+    return -1;
+}
+#else
+/* No AVX2 on this architecture: fall back to the word-at-a-time search.
+ */
+int64_t find_free_run_avx2(bitmap_t *bitmap, int64_t n) {
+    return find_free_run_scalar(bitmap, n);
+}
+#endif
+
+/* Helper function to mark `n` pages from the first one as used (if `used`
+   is TRUE) or free, a word at a time.
+ */
+static void mark_pages(bitmap_t *bitmap, int64_t first, int64_t n, int used) {
+    int64_t end = first + n;
+    while (first < end) {
+        int64_t w = first / WORD_BITS;
+        int offset = first % WORD_BITS;
+        int64_t count = WORD_BITS - offset;
+        if (count > end - first)
+            count = end - first;
+
+        uint64_t mask = (count == WORD_BITS) ? FULL_WORD
+                : (((uint64_t) 1 << count) - 1) << offset;
+        if (used)
+            bitmap->words[w] |= mask;
+        else
+            bitmap->words[w] &= ~mask;
+        first += count;
+    }
+}
+
+/* Helper function to add the run of `n` free pages from the first one
+   to the run index.
+ */
+static void add_run(bitmap_t *bitmap, int64_t first, int64_t n) {
+    avl_insert(bitmap->runs_by_start, make_avl_key(first, n), NULL);
+    avl_insert(bitmap->runs_by_length, make_avl_key(n, first), NULL);
+}
+
+/* Helper function to remove the run of `n` free pages from the first one
+   from the run index.
+ */
+static void remove_run(bitmap_t *bitmap, int64_t first, int64_t n) {
+    avl_delete(bitmap->runs_by_start, make_avl_key(first, n));
+    avl_delete(bitmap->runs_by_length, make_avl_key(n, first));
+}
+
+/* Counts the maximal runs of free pages, storing their number in 
+   `num_runs` and the length of the longest in `longest`.
+ * Reads the run index, without scanning the bitmap.
+ */
+void bitmap_free_runs(bitmap_t *bitmap, int64_t *num_runs, int64_t *longest) {
+    assert(bitmap && num_runs && longest);
+    avl_node_t *max = avl_max(bitmap->runs_by_length);
+    *num_runs = bitmap->runs_by_length->count;
+    *longest = max ? max->key.primary : 0;
+}
+
+/* Allocates the lowest run of pages holding the given size.
+ * Returns its starting address, or NOT_ASSIGNED if no run fits.
+ */
+mem_addr_t bitmap_alloc(bitmap_t *bitmap, mem_addr_t size) {
+    assert(bitmap);
+    int64_t n = pages_needed(size);
+    if (n > bitmap->num_pages)
+        return NOT_ASSIGNED;
+
+    int64_t first = bitmap->find_free_run(bitmap, n);
+    if (first < 0)
+        return NOT_ASSIGNED;
+
+    mark_pages(bitmap, first, n, 1);
+    // split the run it was taken from
+    avl_node_t *run = avl_floor(bitmap->runs_by_start, 
+            make_avl_key(first, INT64_MAX));
+    assert(run);
+    int64_t run_first = run->key.primary, run_n = run->key.secondary;
+    assert(run_first + run_n >= first + n);
+    remove_run(bitmap, run_first, run_n);
+    if (first > run_first)
+        add_run(bitmap, run_first, first - run_first);
+    if (run_first + run_n > first + n)
+        add_run(bitmap, first + n, run_first + run_n - (first + n));
+    return first * PAGE_SIZE;
+}
+
+/* Frees the pages starting at the address that were allocated for the size.
+ */
+void bitmap_free(bitmap_t *bitmap, mem_addr_t start, mem_addr_t size) {
+    assert(bitmap && start % PAGE_SIZE == 0);
+    int64_t first = start / PAGE_SIZE, n = pages_needed(size);
+    mark_pages(bitmap, first, n, 0);
+
+    // merge with the runs just before and after it
+    avl_node_t *run = first > 0 ? avl_floor(bitmap->runs_by_start, 
+            make_avl_key(first - 1, INT64_MAX)) : NULL;
+    if (run && run->key.primary + run->key.secondary == first) {
+        int64_t run_first = run->key.primary;
+        remove_run(bitmap, run_first, run->key.secondary);
+        n += first - run_first;
+        first = run_first;
+    }
+    run = avl_lower_bound(bitmap->runs_by_start, make_avl_key(first + n, 0));
+    if (run && run->key.primary == first + n) {
+        int64_t run_n = run->key.secondary;
+        remove_run(bitmap, first + n, run_n);
+        n += run_n;
+    }
+    add_run(bitmap, first, n);
+}
+
+/* Frees all memory allocated to the bitmap.
+ */
+void free_bitmap(bitmap_t *bitmap) {
+    assert(bitmap);
+    free(bitmap->words);
+    bitmap->words = NULL;
+    free_avl(bitmap->runs_by_start);
+    free_avl(bitmap->runs_by_length);
+    free(bitmap);
+    bitmap = NULL;
+}
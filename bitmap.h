@@ -0,0 +1,80 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * bitmap.h :
+              = the interface of the module `bitmap` of the project
+              = simulates memory as fixed-size pages, tracked by a bitmap
+                (one bit per page, set if the page is in use)
+ ----------------------------------------------------------------------------*/
+
+#ifndef _BITMAP_H_
+#define _BITMAP_H_
+
+#include <stdint.h>
+#include "process_data.h"
+#include "avl_tree.h"
+
+#define PAGE_SIZE 4           // size of a page in MB
+#define WORD_BITS 64          // pages tracked per word of the bitmap
+
+typedef struct bitmap bitmap_t;
+
+/* function pointer type for finding a run of free pages */
+typedef int64_t (*free_run_fp_t) (bitmap_t *, int64_t);
+
+struct bitmap {
+    int64_t num_pages;
+    int64_t num_words;
+    uint64_t *words;          // bit i of word w tracks page (64w + i)
+    free_run_fp_t find_free_run;  // fastest search the CPU supports
+    // the maximal runs of free pages, keyed by (first page, length) and 
+    // by (length, first page), kept up to date as runs are allocated
+    // and freed
+    avl_tree_t *runs_by_start;
+    avl_tree_t *runs_by_length;
+};
+
+
+/************** function declarations **************/
+
+/* Creates and returns a bitmap over the pages of memory of the given
+   capacity (in MB), initially free.
+ */
+bitmap_t *create_bitmap(mem_addr_t capacity);
+
+/* Returns the number of pages needed to hold the given size (at least one).
+ */
+int64_t pages_needed(mem_addr_t size);
+
+/* Returns the index of the first page of the lowest run of `n` free pages,
+   or -1 if there is none.
+ * Scans the bitmap a word (64 pages) at a time.
+ */
+int64_t find_free_run_scalar(bitmap_t *bitmap, int64_t n);
+
+/* Same as `find_free_run_scalar`, but skips fully used or fully free
+   stretches of the bitmap 256 pages at a time with AVX2.
+ * Only to be called when the CPU supports AVX2.
+ */
+int64_t find_free_run_avx2(bitmap_t *bitmap, int64_t n);
+
+/* Counts the maximal runs of free pages, storing their number in 
+   `num_runs` and the length of the longest in `longest`.
+ * Reads the run index, without scanning the bitmap.
+ */
+void bitmap_free_runs(bitmap_t *bitmap, int64_t *num_runs, int64_t *longest);
+
+/* Allocates the lowest run of pages holding the given size.
+ * Returns its starting address, or NOT_ASSIGNED if no run fits.
+ */
+mem_addr_t bitmap_alloc(bitmap_t *bitmap, mem_addr_t size);
+
+/* Frees the pages starting at the address that were allocated for the size.
+ */
+void bitmap_free(bitmap_t *bitmap, mem_addr_t start, mem_addr_t size);
+
+/* Frees all memory allocated to the bitmap.
+ */
+void free_bitmap(bitmap_t *bitmap);
+
+
+#endif
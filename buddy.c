@@ -0,0 +1,135 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * buddy.c :
+              = the implementation of the module `buddy` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include "buddy.h"
+
+/* some 'private' helper functions */
+static avl_key_t block_key(mem_addr_t start);
+static void push_block(buddy_t *buddy, mem_addr_t start, int order);
+static void remove_block(buddy_t *buddy, mem_addr_t start, int order);
+
+
+/* Creates and returns a buddy allocator over memory of the given capacity,
+   initially free.
+ */
+buddy_t *create_buddy(mem_addr_t capacity) {
+    assert(capacity > 0);
+    buddy_t *buddy = malloc(sizeof(*buddy));
+    assert(buddy);
+
+    buddy->capacity = capacity;
+    buddy->nonempty = 0;
+    for (int k = 0; k <= MAX_BUDDY_ORDER; k++)
+        buddy->free_blocks[k] = make_empty_avl();
+
+    // cover the capacity with free blocks, largest first, so that each
+    // block is aligned to its own size (e.g. 3072 = 2048 @ 0 + 1024 @ 2048)
+    buddy->max_order = -1;
+    mem_addr_t start = 0;
+    for (int k = MAX_BUDDY_ORDER; k >= 0; k--) {
+        if (capacity & ((mem_addr_t) 1 << k)) {
+            if (buddy->max_order < 0)
+                buddy->max_order = k;
+            push_block(buddy, start, k);
+            start += (mem_addr_t) 1 << k;
+        }
+    }
+
+    return buddy;
+}
+
+/* Returns the smallest order of a block that can hold the given size.
+ */
+int buddy_order(mem_addr_t size) {
+    int order = 0;
+    while (order <= MAX_BUDDY_ORDER && ((mem_addr_t) 1 << order) < size)
+        order++;
+    return order;
+}
+
+/* Helper function to return the key of a free block.
+ */
+static avl_key_t block_key(mem_addr_t start) {
+    return make_avl_key(start, 0);
+}
+
+/* Helper function to add the block to the free list of its order.
+ */
+static void push_block(buddy_t *buddy, mem_addr_t start, int order) {
+    avl_insert(buddy->free_blocks[order], block_key(start), NULL);
+    buddy->nonempty |= (uint64_t) 1 << order;
+}
+
+/* Helper function to remove the block from the free list of its order.
+ */
+static void remove_block(buddy_t *buddy, mem_addr_t start, int order) {
+    avl_delete(buddy->free_blocks[order], block_key(start));
+    if (is_empty_avl(buddy->free_blocks[order]))
+        buddy->nonempty &= ~((uint64_t) 1 << order);
+}
+
+/* Allocates a block for the given size (the lowest-addressed block of the
+   smallest sufficient order, split down as needed).
+ * Returns its starting address, or NOT_ASSIGNED if no block fits.
+ */
+mem_addr_t buddy_alloc(buddy_t *buddy, mem_addr_t size) {
+    assert(buddy);
+    int order = buddy_order(size);
+    if (order > buddy->max_order)
+        return NOT_ASSIGNED;
+
+    // smallest order >= `order` with a free block
+    uint64_t candidates = buddy->nonempty & ~(((uint64_t) 1 << order) - 1);
+    if (!candidates)
+        return NOT_ASSIGNED;
+    int k = __builtin_ctzll(candidates);
+
+    mem_addr_t start = avl_min(buddy->free_blocks[k])->key.primary;
+    remove_block(buddy, start, k);
+
+    // split down, freeing the upper halves
+    while (k > order) {
+        k--;
+        push_block(buddy, start + ((mem_addr_t) 1 << k), k);
+    }
+
+    return start;
+}
+
+/* Frees the block starting at the address that was allocated for the size,
+   coalescing it with its free buddies.
+ */
+void buddy_free(buddy_t *buddy, mem_addr_t start, mem_addr_t size) {
+    assert(buddy);
+    int order = buddy_order(size);
+
+    while (order < buddy->max_order) {
+        mem_addr_t buddy_start = start ^ ((mem_addr_t) 1 << order);
+        if (!avl_find(buddy->free_blocks[order], block_key(buddy_start)))
+            break; // buddy in use (or split) -> stop coalescing
+
+        remove_block(buddy, buddy_start, order);
+        if (buddy_start < start)
+            start = buddy_start;
+        order++;
+    }
+
+    push_block(buddy, start, order);
+}
+
+/* Frees all memory allocated to the buddy allocator.
+ */
+void free_buddy(buddy_t *buddy) {
+    assert(buddy);
+    for (int k = 0; k <= MAX_BUDDY_ORDER; k++) {
+        free_avl(buddy->free_blocks[k]);
+        buddy->free_blocks[k] = NULL;
+    }
+    free(buddy);
+    buddy = NULL;
+}
@@ -0,0 +1,54 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * buddy.h :
+              = the interface of the module `buddy` of the project
+              = simulates a power-of-two buddy allocator, with a free list
+                (ordered by address) for each block order
+ ----------------------------------------------------------------------------*/
+
+#ifndef _BUDDY_H_
+#define _BUDDY_H_
+
+#include <stdint.h>
+#include "process_data.h"
+#include "avl_tree.h"
+
+#define MAX_BUDDY_ORDER 62   // blocks hold at most 2^62 MB
+
+typedef struct {
+    mem_addr_t capacity;
+    int max_order;           // order of the largest block
+    // free blocks of size 2^k MB, keyed by (start, 0)
+    avl_tree_t *free_blocks[MAX_BUDDY_ORDER+1];
+    uint64_t nonempty;       // bit k is set if order k has a free block
+} buddy_t;
+
+
+/************** function declarations **************/
+
+/* Creates and returns a buddy allocator over memory of the given capacity,
+   initially free.
+ */
+buddy_t *create_buddy(mem_addr_t capacity);
+
+/* Returns the smallest order of a block that can hold the given size.
+ */
+int buddy_order(mem_addr_t size);
+
+/* Allocates a block for the given size (the lowest-addressed block of the
+   smallest sufficient order, split down as needed).
+ * Returns its starting address, or NOT_ASSIGNED if no block fits.
+ */
+mem_addr_t buddy_alloc(buddy_t *buddy, mem_addr_t size);
+
+/* Frees the block starting at the address that was allocated for the size,
+   coalescing it with its free buddies.
+ */
+void buddy_free(buddy_t *buddy, mem_addr_t start, mem_addr_t size);
+
+/* Frees all memory allocated to the buddy allocator.
+ */
+void free_buddy(buddy_t *buddy);
+
+
+#endif
@@ -0,0 +1,129 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * heap.c :
+              = the implementation of the module `heap` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include "heap.h"
+
+/* some 'private' helper functions */
+static int orders_before(heap_t *heap, int i, int j);
+static void swap_entries(heap_t *heap, int i, int j);
+static void sift_up(heap_t *heap, int i);
+static void sift_down(heap_t *heap, int i);
+
+
+/* Creates and returns an empty heap ordered by the comparison function.
+ */
+heap_t *make_empty_heap(heap_cmp_fp_t cmp) {
+    assert(cmp);
+    heap_t *heap = malloc(sizeof(*heap));
+    assert(heap);
+    heap->size = INITIAL_HEAP_SIZE;
+    heap->entries = malloc(heap->size * sizeof(*heap->entries));
+    assert(heap->entries);
+    heap->count = 0;
+    heap->next_seq = 0;
+    heap->cmp = cmp;
+    return heap;
+}
+
+/* Returns TRUE (1) if the heap is empty, FALSE (0) otherwise.
+ */
+int is_empty_heap(heap_t *heap) {
+    assert(heap);
+    return heap->count == 0;
+}
+
+/* Helper function to return TRUE (1) if the entry at index `i` orders
+   before the one at index `j`, FALSE (0) otherwise.
+ */
+static int orders_before(heap_t *heap, int i, int j) {
+    int cmp = heap->cmp(heap->entries[i].data, heap->entries[j].data);
+    if (cmp != 0)
+        return cmp < 0;
+    return heap->entries[i].seq < heap->entries[j].seq;
+}
+
+/* Helper function to swap the entries at the two indices.
+ */
+static void swap_entries(heap_t *heap, int i, int j) {
+    heap_entry_t tmp = heap->entries[i];
+    heap->entries[i] = heap->entries[j];
+    heap->entries[j] = tmp;
+}
+
+/* Helper function to move the entry at the index up to its place.
+ */
+static void sift_up(heap_t *heap, int i) {
+    while (i > 0 && orders_before(heap, i, (i - 1) / 2)) {
+        swap_entries(heap, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+/* Helper function to move the entry at the index down to its place.
+ */
+static void sift_down(heap_t *heap, int i) {
+    while (1) {
+        int first = i;
+        int left = 2 * i + 1, right = 2 * i + 2;
+        if (left < heap->count && orders_before(heap, left, first))
+            first = left;
+        if (right < heap->count && orders_before(heap, right, first))
+            first = right;
+        if (first == i)
+            return;
+        swap_entries(heap, i, first);
+        i = first;
+    }
+}
+
+/* Inserts the data into the heap.
+ */
+void heap_push(heap_t *heap, void *data) {
+    assert(heap);
+    if (heap->count == heap->size) {
+        heap->size *= 2;
+        heap->entries = realloc(heap->entries,
+                heap->size * sizeof(*heap->entries));
+        assert(heap->entries);
+    }
+    heap->entries[heap->count].data = data;
+    heap->entries[heap->count].seq = heap->next_seq++;
+    sift_up(heap, heap->count++);
+}
+
+/* Returns the data that orders first (the earliest inserted on ties), 
+   without removing it, or NULL if the heap is empty.
+ */
+void *heap_peek(heap_t *heap) {
+    assert(heap);
+    return is_empty_heap(heap) ? NULL : heap->entries[0].data;
+}
+
+/* Removes and returns the data that orders first (the earliest inserted
+   on ties), or NULL if the heap is empty.
+ */
+void *heap_pop(heap_t *heap) {
+    assert(heap);
+    if (is_empty_heap(heap))
+        return NULL;
+
+    void *data = heap->entries[0].data;
+    heap->entries[0] = heap->entries[--heap->count];
+    sift_down(heap, 0);
+    return data;
+}
+
+/* Frees all memory allocated to the heap (but not the data held).
+ */
+void free_heap(heap_t *heap) {
+    assert(heap);
+    free(heap->entries);
+    heap->entries = NULL;
+    free(heap);
+    heap = NULL;
+}
@@ -0,0 +1,64 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * heap.h :
+              = the interface of the module `heap` of the project
+              = a polymorphic binary min-heap, ordered by a given comparison
+                function, and by the order of insertion on ties
+ ----------------------------------------------------------------------------*/
+
+#ifndef _HEAP_H_
+#define _HEAP_H_
+
+#include <stdint.h>
+
+#define INITIAL_HEAP_SIZE 16
+
+/* function pointer type for comparing the data of two entries:
+   returns negative if the first orders first, positive if the second does,
+   0 otherwise */
+typedef int (*heap_cmp_fp_t) (void *, void *);
+
+typedef struct {
+    void *data;
+    uint64_t seq;              // when it was inserted (to break ties)
+} heap_entry_t;
+
+typedef struct {
+    heap_entry_t *entries;     // the heap, rooted at index 0
+    int count;
+    int size;                  // number of entries allocated
+    uint64_t next_seq;
+    heap_cmp_fp_t cmp;
+} heap_t;
+
+
+/************** function declarations **************/
+
+/* Creates and returns an empty heap ordered by the comparison function.
+ */
+heap_t *make_empty_heap(heap_cmp_fp_t cmp);
+
+/* Returns TRUE (1) if the heap is empty, FALSE (0) otherwise.
+ */
+int is_empty_heap(heap_t *heap);
+
+/* Inserts the data into the heap.
+ */
+void heap_push(heap_t *heap, void *data);
+
+/* Returns the data that orders first (the earliest inserted on ties), 
+   without removing it, or NULL if the heap is empty.
+ */
+void *heap_peek(heap_t *heap);
+
+/* Removes and returns the data that orders first (the earliest inserted
+   on ties), or NULL if the heap is empty.
+ */
+void *heap_pop(heap_t *heap);
+
+/* Frees all memory allocated to the heap (but not the data held).
+ */
+void free_heap(heap_t *heap);
+
+
+#endif
@@ -0,0 +1,180 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * hole_array.c :
+              = the implementation of the module `hole_array` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hole_array.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_AVX2_KERNEL
+#endif
+
+/* some 'private' helper functions */
+static mem_addr_t *alloc_lengths(int64_t size);
+static void grow(hole_array_t *holes);
+
+
+/* Creates and returns an empty hole array.
+ */
+hole_array_t *create_hole_array() {
+    hole_array_t *holes = malloc(sizeof(*holes));
+    assert(holes);
+    holes->count = 0;
+    holes->size = INITIAL_HOLE_ARRAY_SIZE;
+    holes->starts = malloc(holes->size * sizeof(*holes->starts));
+    assert(holes->starts);
+    holes->lengths = alloc_lengths(holes->size);
+
+    holes->find_fit = find_fit_scalar;
+#ifdef HAS_AVX2_KERNEL
+    if (__builtin_cpu_supports("avx2"))
+        holes->find_fit = find_fit_avx2;
+#endif
+
+    return holes;
+}
+
+/* Helper function to return an aligned array of `size` lengths.
+ */
+static mem_addr_t *alloc_lengths(int64_t size) {
+    // the size in bytes must be a multiple of the alignment
+    mem_addr_t *lengths = aligned_alloc(HOLE_ARRAY_ALIGN, 
+            size * sizeof(*lengths));
+    assert(lengths);
+    return lengths;
+}
+
+/* Helper function to double the number of slots of the hole array.
+ */
+static void grow(hole_array_t *holes) {
+    holes->size *= 2;
+    holes->starts = realloc(holes->starts, 
+            holes->size * sizeof(*holes->starts));
+    assert(holes->starts);
+
+    // aligned memory cannot be reallocated in place
+    mem_addr_t *lengths = alloc_lengths(holes->size);
+    memcpy(lengths, holes->lengths, holes->count * sizeof(*lengths));
+    free(holes->lengths);
+    holes->lengths = lengths;
+}
+
+/* Returns the index of the first hole starting at or after the address
+   (`count` if there is none).
+ */
+int64_t hole_array_lower_bound(hole_array_t *holes, mem_addr_t start) {
+    assert(holes);
+    int64_t low = 0, high = holes->count;
+    while (low < high) {
+        int64_t mid = low + (high - low) / 2;
+        if (holes->starts[mid] < start)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+/* Adds the hole starting at the address, of the given length.
+ */
+void hole_array_insert(hole_array_t *holes, mem_addr_t start, 
+        mem_addr_t length) {
+    assert(holes);
+    if (holes->count == holes->size) // out of slots
+        grow(holes);
+
+    // shift the following holes up by one slot
+    int64_t index = hole_array_lower_bound(holes, start);
+    int64_t num_following = holes->count - index;
+    memmove(&holes->starts[index + 1], &holes->starts[index], 
+            num_following * sizeof(*holes->starts));
+    memmove(&holes->lengths[index + 1], &holes->lengths[index], 
+            num_following * sizeof(*holes->lengths));
+    holes->starts[index] = start;
+    holes->lengths[index] = length;
+    holes->count++;
+}
+
+/* Removes the hole starting at the address.
+ */
+void hole_array_remove(hole_array_t *holes, mem_addr_t start) {
+    assert(holes);
+    int64_t index = hole_array_lower_bound(holes, start);
+    assert(index < holes->count && holes->starts[index] == start);
+
+    // shift the following holes down by one slot
+    holes->count--;
+    int64_t num_following = holes->count - index;
+    memmove(&holes->starts[index], &holes->starts[index + 1], 
+            num_following * sizeof(*holes->starts));
+    memmove(&holes->lengths[index], &holes->lengths[index + 1], 
+            num_following * sizeof(*holes->lengths));
+}
+
+/* Returns the index of the first length in [from, to) that is at least 
+   the size, or -1 if there is none.
+ */
+int64_t find_fit_scalar(const mem_addr_t *lengths, int64_t from, int64_t to,
+        mem_addr_t size) {
+    assert(lengths || from >= to);
+    for (int64_t i = from; i < to; i++) {
+        if (lengths[i] >= size)
+            return i;
+    }
+    return -1;
+}
+
+#ifdef HAS_AVX2_KERNEL
+/* Same as `find_fit_scalar`, but compares 8 lengths at a time with AVX2.
+ * Only to be called when the CPU supports AVX2.
+ */
+__attribute__((target("avx2")))
+int64_t find_fit_avx2(const mem_addr_t *lengths, int64_t from, int64_t to,
+        mem_addr_t size) {
+    assert(lengths || from >= to);
+    // lengths > size - 1 (the sizes of holes and processes are positive)
+    const __m256i bound = _mm256_set1_epi64x(size - 1);
+    int64_t i = from;
+
+    // scalar up to the first aligned lane, for the aligned loads
+    for (; i < to && (i % 4); i++) {
+        if (lengths[i] >= size)
+            return i;
+    }
+    for (; i + 8 <= to; i += 8) {
+        __m256i lo = _mm256_load_si256((const __m256i *) &lengths[i]);
+        __m256i hi = _mm256_load_si256((const __m256i *) &lengths[i + 4]);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(
+                _mm256_cmpgt_epi64(lo, bound)))
+                | _mm256_movemask_pd(_mm256_castsi256_pd(
+                _mm256_cmpgt_epi64(hi, bound))) << 4;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return find_fit_scalar(lengths, i, to, size);
+}
+#else
+/* No AVX2 on this architecture: fall back to the one-at-a-time scan.
+ */
+int64_t find_fit_avx2(const mem_addr_t *lengths, int64_t from, int64_t to,
+        mem_addr_t size) {
+    return find_fit_scalar(lengths, from, to, size);
+}
+#endif
+
+/* Frees all memory allocated to the hole array.
+ */
+void free_hole_array(hole_array_t *holes) {
+    assert(holes);
+    free(holes->starts);
+    holes->starts = NULL;
+    free(holes->lengths);
+    holes->lengths = NULL;
+    free(holes);
+    holes = NULL;
+}
@@ -0,0 +1,70 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * hole_array.h :
+              = the interface of the module `hole_array` of the project
+              = keeps the holes of segment memory in address order as
+                packed arrays of starts and lengths, so that the first hole
+                that fits can be found by a vectorized scan
+ ----------------------------------------------------------------------------*/
+
+#ifndef _HOLE_ARRAY_H_
+#define _HOLE_ARRAY_H_
+
+#include <stdint.h>
+#include "process_data.h"
+
+#define HOLE_ARRAY_ALIGN 32        // alignment of the lengths (an AVX2 lane)
+#define INITIAL_HOLE_ARRAY_SIZE 16
+
+/* function pointer type for finding the first of the lengths (in the index 
+   range [from, to)) that holds a size */
+typedef int64_t (*fit_scan_fp_t) (const mem_addr_t *, int64_t, int64_t, 
+        mem_addr_t);
+
+typedef struct {
+    int64_t count;             // number of holes
+    int64_t size;              // number of slots allocated
+    mem_addr_t *starts;        // in ascending order
+    mem_addr_t *lengths;       // packed and aligned, parallel to `starts`
+    fit_scan_fp_t find_fit;    // fastest scan the CPU supports
+} hole_array_t;
+
+
+/************** function declarations **************/
+
+/* Creates and returns an empty hole array.
+ */
+hole_array_t *create_hole_array();
+
+/* Adds the hole starting at the address, of the given length.
+ */
+void hole_array_insert(hole_array_t *holes, mem_addr_t start, 
+        mem_addr_t length);
+
+/* Removes the hole starting at the address.
+ */
+void hole_array_remove(hole_array_t *holes, mem_addr_t start);
+
+/* Returns the index of the first hole starting at or after the address
+   (`count` if there is none).
+ */
+int64_t hole_array_lower_bound(hole_array_t *holes, mem_addr_t start);
+
+/* Returns the index of the first length in [from, to) that is at least 
+   the size, or -1 if there is none.
+ */
+int64_t find_fit_scalar(const mem_addr_t *lengths, int64_t from, int64_t to,
+        mem_addr_t size);
+
+/* Same as `find_fit_scalar`, but compares 8 lengths at a time with AVX2.
+ * Only to be called when the CPU supports AVX2.
+ */
+int64_t find_fit_avx2(const mem_addr_t *lengths, int64_t from, int64_t to,
+        mem_addr_t size);
+
+/* Frees all memory allocated to the hole array.
+ */
+void free_hole_array(hole_array_t *holes);
+
+
+#endif
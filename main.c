@@ -9,13 +9,88 @@
  *
  * The executable is named `allocate`.
  * Usage: 
-   allocate -f <filename> -s (SJF | RR) -m (infinite | best-fit) -q (1 | 2 | 3)
+   allocate -f <filename> -s (SJF | RR | MSJF | SRTF | MLFQ | CFS) 
+            -m (infinite | best-fit | buddy | first-fit | next-fit | worst-fit |
+                bitmap | virtual | tlsf | slab) 
+            -q <quantum>
+            [-l (list | array)] [-M <capacity>] [-C <threshold>]
+            [-t <stats-file>] [-p <penalty>] [-S <latency>[,<latency>]]
+            [-B <capacity>[,<capacity>...]] 
+            [-P (local | least-loaded | best-fit)]
+            [-a (fifo | largest-first | best-pack)] [-c <cores>]
+            [-L <slice>[,<slice>...]] [-b <period>]
  *
  * -f <filename>       : a relative/absolute path to the input file describing 
-                         the processes. 
- * -s <scheduler>      : scheduler is one of {SJF, RR}.
- * -m <memory-strategy>: memory-strategy is one of {infinite, best-fit}.
- * -q <quantum>        : quantum is one of {1, 2, 3}.
+                         the processes, a line each: its arrival time, name,
+                         service time, memory requirement, and optionally 
+                         its weight (its share of the CPU under CFS; 1 by 
+                         default). 
+ * -s <scheduler>      : scheduler is one of {SJF, RR, MSJF, SRTF, MLFQ, CFS}; 
+                         MSJF is SJF that, while processes wait for memory,
+                         favours the jobs whose completion would let one 
+                         fit; SRTF preempts the running process (at the 
+                         end of a quantum) for a ready one with less time
+                         remaining; MLFQ runs the processes of the highest 
+                         priority level in turn, dropping each a level 
+                         when it uses up its level's time slice; CFS runs
+                         the process that has run the least for its weight.
+ * -m <memory-strategy>: memory-strategy is one of {infinite, best-fit, 
+                         buddy, first-fit, next-fit, worst-fit, bitmap,
+                         virtual, tlsf, slab}.
+ * -q <quantum>        : quantum is a positive integer (e.g. 1, 2 or 3).
+ * -l <memory-map>     : (optional) memory-map is one of {list, array}, 
+                         the representation of the memory; list by default.
+ * -M <capacity>       : (optional) the memory capacity in MB, optionally 
+                         suffixed by G or T (e.g. 4T); 2048 by default.
+ * -C <threshold>      : (optional) compact memory when a process fits in the
+                         total free memory but in no hole, and the external 
+                         fragmentation is at least the threshold (in [0, 1]);
+                         no compaction by default (nor under slab, whose
+                         slabs cannot move).
+ * -t <stats-file>     : (optional) write the state of the memory in each 
+                         cycle to the file (as CSV), and print a summary
+                         after the performance statistics.
+ * -p <penalty>        : (optional) the time taken to swap in a page of 
+                         virtual memory, during which the process's core 
+                         idles; 1 by default.
+ * -S <out>[,<in>]     : (optional) when a process does not fit in memory, 
+                         swap out the READY processes that have held memory
+                         the longest, taking time `out` each, and swap them
+                         back in when scheduled, taking time `in` (`out` by
+                         default), during which the core of the process 
+                         made room for (or swapped in) idles; no swapping 
+                         by default.
+ * -B <capacities>     : (optional) split the memory into independent banks
+                         (e.g. one per NUMA node) of the given capacities, 
+                         separated by commas (each as for -M); each bank has
+                         its own allocator, and addresses run through the 
+                         banks in order. Overrides -M.
+ * -P <placement>      : (optional) placement is one of {local, 
+                         least-loaded, best-fit}, how a bank is chosen for
+                         a process: its own bank (arrivals take turns over 
+                         the banks) if it fits, the bank with the most free
+                         memory for its capacity, or the bank with the 
+                         smallest hole that fits; local by default.
+ * -a <admission>      : (optional) admission is one of {fifo, largest-first,
+                         best-pack}, the order waiting processes are tried
+                         in whenever memory changes: arrival order, largest
+                         memory requirement first, or first the combination
+                         of processes that fills the largest hole the most
+                         (searched among the earliest 64 waiting, for holes
+                         of up to 64G, else largest first); fifo by default.
+ * -c <cores>          : (optional) the number of CPU cores (up to 64), each
+                         running processes from its own ready processes 
+                         (processes becoming ready join the least busy core,
+                         and an idle core steals from the core with the most
+                         ready processes); 1 by default. With more than one, 
+                         the transcript gives each process's core, and the
+                         statistics each core's utilization.
+ * -L <slices>         : (optional) the time slices (in quanta, at most 16 
+                         of them, separated by commas) of the MLFQ priority
+                         levels, from the highest; 1,2,4 by default.
+ * -b <period>         : (optional) the time between raising all processes
+                         to the highest MLFQ priority level (0 for never);
+                         100 by default.
  ----------------------------------------------------------------------------*/
 
 
@@ -23,6 +98,9 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
 #include "management.h"
 
 #define IMPLEMENTS_REAL_PROCESS
@@ -31,23 +109,50 @@
 #define SCHEDULER_OPT 's'
 #define MEMORY_OPT 'm'
 #define QUANTUM_OPT 'q'
-#define NUM_ARGS 4
+#define MEMORY_MAP_OPT 'l'
+#define CAPACITY_OPT 'M'
+#define COMPACTION_OPT 'C'
+#define STATS_OPT 't'
+#define PENALTY_OPT 'p'
+#define SWAP_OPT 'S'
+#define BANKS_OPT 'B'
+#define PLACEMENT_OPT 'P'
+#define ADMISSION_OPT 'a'
+#define CORES_OPT 'c'
+#define LEVELS_OPT 'L'
+#define BOOST_OPT 'b'
+#define NUM_ARGS 4  // number of required arguments
 
-void process_args(int argc, char **argv, int *filename_id, int *scheduler_id, 
-    int *memory_strategy_id, int *quantum);
+#define DEFAULT_MEMORY_MAP "list"
+#define DEFAULT_PLACEMENT "local"
+#define DEFAULT_ADMISSION "fifo"
+#define DEFAULT_NUM_CORES 1
+
+#define MB_PER_GB 1024
+#define MB_PER_TB (1024 * 1024)
+
+void process_args(int argc, char **argv, char **filename, 
+        manager_config_t *config);
+mem_addr_t parse_capacity(char *str);
+double parse_fraction(char *str);
+uint32_t parse_time(char *str);
+int parse_quantum(char *str);
+void parse_latencies(char *str, int64_t *out, int64_t *in);
+int parse_banks(char *str, mem_addr_t *capacities);
+int parse_cores(char *str);
+int parse_levels(char *str, int *quanta);
 
 
 int main(int argc, char **argv) {
-    int filename_id, scheduler_id, memory_strategy_id, quantum;
-    process_args(argc, argv, &filename_id, &scheduler_id, 
-            &memory_strategy_id, &quantum);
+    char *filename;
+    manager_config_t config;
+    process_args(argc, argv, &filename, &config);
 
-    FILE *f = fopen(argv[filename_id], "r");
+    FILE *f = fopen(filename, "r");
     assert(f);
 
     // build the manager
-    process_manager_t *process_manager = create_manager(f, argv[scheduler_id], 
-            argv[memory_strategy_id], quantum);
+    process_manager_t *process_manager = create_manager(f, &config);
     fclose(f);
 
     // run the manager
@@ -59,35 +164,87 @@ int main(int argc, char **argv) {
     return 0;
 }
 
-/* Extracts the command line arguments, and stores the associated index/value
-   in the corresponding pointers.
+/* Extracts the command line arguments, and stores the filename and 
+   the manager's options in the corresponding pointers.
  */
-void process_args(int argc, char **argv, int *filename_id, int *scheduler_id, 
-    int *memory_strategy_id, int *quantum) {
+void process_args(int argc, char **argv, char **filename, 
+        manager_config_t *config) {
     
     int c;
     opterr = 0;
     int values_read = 0;
+
+    // optional arguments
+    config->memory_map = DEFAULT_MEMORY_MAP;
+    config->memory_capacity = DEFAULT_MEMORY_CAPACITY;
+    config->compaction_threshold = NO_COMPACTION;
+    config->stats_file = NULL;
+    config->swap_penalty = DEFAULT_SWAP_PENALTY;
+    config->swap_out_latency = config->swap_in_latency = NO_SWAPPING;
+    config->num_banks = 0;
+    config->placement = DEFAULT_PLACEMENT;
+    config->admission = DEFAULT_ADMISSION;
+    config->num_cores = DEFAULT_NUM_CORES;
+    config->num_levels = 0;
+    config->boost_period = DEFAULT_BOOST_PERIOD;
     
-    while ((c = getopt(argc, argv, "f:s:m:q:")) != -1) {
+    while ((c = getopt(argc, argv, "f:s:m:q:l:M:C:t:p:S:B:P:a:c:L:b:")) != -1) {
         switch (c) {
             case FILE_OPT:
-                // optind = index of the next element to be processed in argv
-                *filename_id = optind-1;
+                *filename = optarg;
                 values_read++;
                 break;
             case SCHEDULER_OPT:
-                *scheduler_id = optind-1;
+                config->scheduler = optarg;
                 values_read++;
                 break;
             case MEMORY_OPT:
-                *memory_strategy_id = optind-1;
+                config->memory_strategy = optarg;
                 values_read++;
                 break;
             case QUANTUM_OPT:
-                *quantum = atoi(optarg);
+                config->quantum = parse_quantum(optarg);
                 values_read++;
                 break;
+            case MEMORY_MAP_OPT:
+                config->memory_map = optarg;
+                break;
+            case CAPACITY_OPT:
+                config->memory_capacity = parse_capacity(optarg);
+                break;
+            case COMPACTION_OPT:
+                config->compaction_threshold = parse_fraction(optarg);
+                break;
+            case STATS_OPT:
+                config->stats_file = optarg;
+                break;
+            case PENALTY_OPT:
+                config->swap_penalty = parse_time(optarg);
+                break;
+            case SWAP_OPT:
+                parse_latencies(optarg, &config->swap_out_latency, 
+                        &config->swap_in_latency);
+                break;
+            case BANKS_OPT:
+                config->num_banks = 
+                        parse_banks(optarg, config->bank_capacities);
+                break;
+            case PLACEMENT_OPT:
+                config->placement = optarg;
+                break;
+            case ADMISSION_OPT:
+                config->admission = optarg;
+                break;
+            case CORES_OPT:
+                config->num_cores = parse_cores(optarg);
+                break;
+            case LEVELS_OPT:
+                config->num_levels = 
+                        parse_levels(optarg, config->level_quanta);
+                break;
+            case BOOST_OPT:
+                config->boost_period = parse_time(optarg);
+                break;
             case ':':
                 printf("Option needs a value.\n");
                 break;
@@ -103,4 +260,136 @@ void process_args(int argc, char **argv, int *filename_id, int *scheduler_id,
         perror("Invalid number of arguments.\n");
         exit(EXIT_FAILURE);
     }
-}
\ No newline at end of file
+}
+
+/* Parses and returns the memory capacity (in MB) given by the string,
+   a positive integer optionally suffixed by M, G or T.
+ */
+mem_addr_t parse_capacity(char *str) {
+    char *suffix;
+    errno = 0;
+    long long capacity = strtoll(str, &suffix, 10);
+
+    int64_t unit = 1; // MB by default
+    if (*suffix == 'G' || *suffix == 'g') {
+        unit = MB_PER_GB;
+        suffix++;
+    } else if (*suffix == 'T' || *suffix == 't') {
+        unit = MB_PER_TB;
+        suffix++;
+    } else if (*suffix == 'M' || *suffix == 'm') {
+        suffix++;
+    }
+
+    if (errno || suffix == str || *suffix != '\0' || capacity <= 0 
+            || capacity > INT64_MAX / unit) {
+        perror("Invalid memory capacity");
+        exit(EXIT_FAILURE);
+    }
+    return capacity * unit;
+}
+
+/* Parses and returns the fraction (a real number in [0, 1]) given by 
+   the string.
+ */
+double parse_fraction(char *str) {
+    char *end;
+    double fraction = strtod(str, &end);
+    if (end == str || *end != '\0' || fraction < 0 || fraction > 1) {
+        perror("Invalid fraction");
+        exit(EXIT_FAILURE);
+    }
+    return fraction;
+}
+
+/* Parses and returns the (non-negative integer) time given by the string.
+ */
+uint32_t parse_time(char *str) {
+    char *end;
+    errno = 0;
+    unsigned long time = strtoul(str, &end, 10);
+    if (errno || end == str || *end != '\0' || *str == '-' 
+            || time > UINT32_MAX) {
+        perror("Invalid time");
+        exit(EXIT_FAILURE);
+    }
+    return time;
+}
+
+/* Parses and returns the (positive) quantum given by the string.
+ */
+int parse_quantum(char *str) {
+    uint32_t quantum = parse_time(str);
+    if (quantum == 0 || quantum > INT32_MAX) {
+        perror("Invalid quantum");
+        exit(EXIT_FAILURE);
+    }
+    return quantum;
+}
+
+/* Parses the swap-out and swap-in latencies given by the string, as 
+   "<out>[,<in>]", and stores them in the corresponding pointers.
+ */
+void parse_latencies(char *str, int64_t *out, int64_t *in) {
+    char *comma = strchr(str, ',');
+    if (comma)
+        *comma = '\0';
+    *out = parse_time(str);
+    *in = comma ? parse_time(comma + 1) : *out;
+}
+
+/* Parses the bank capacities given by the string, as 
+   "<capacity>[,<capacity>...]", and stores them in `capacities`.
+ * Returns the number of banks.
+ */
+int parse_banks(char *str, mem_addr_t *capacities) {
+    int num_banks = 0;
+    for (char *token = strtok(str, ","); token; token = strtok(NULL, ",")) {
+        if (num_banks == MAX_BANKS) {
+            perror("Too many memory banks");
+            exit(EXIT_FAILURE);
+        }
+        capacities[num_banks++] = parse_capacity(token);
+    }
+    if (!num_banks) {
+        perror("Invalid memory banks");
+        exit(EXIT_FAILURE);
+    }
+    return num_banks;
+}
+
+/* Parses and returns the number of cores (in [1, MAX_CORES]) given by 
+   the string.
+ */
+int parse_cores(char *str) {
+    char *end;
+    long num_cores = strtol(str, &end, 10);
+    if (end == str || *end != '\0' || num_cores < 1 
+            || num_cores > MAX_CORES) {
+        perror("Invalid number of cores");
+        exit(EXIT_FAILURE);
+    }
+    return num_cores;
+}
+
+/* Parses the time slices (positive, in quanta) of the priority levels 
+   given by the string, as "<slice>[,<slice>...]", and stores them in 
+   `quanta`.
+ * Returns the number of levels.
+ */
+int parse_levels(char *str, int *quanta) {
+    int num_levels = 0;
+    for (char *token = strtok(str, ","); token; token = strtok(NULL, ",")) {
+        uint32_t slice = parse_time(token);
+        if (num_levels == MAX_LEVELS || slice == 0 || slice > INT32_MAX) {
+            perror("Invalid priority levels");
+            exit(EXIT_FAILURE);
+        }
+        quanta[num_levels++] = slice;
+    }
+    if (!num_levels) {
+        perror("Invalid priority levels");
+        exit(EXIT_FAILURE);
+    }
+    return num_levels;
+}
@@ -13,44 +13,158 @@
 #include "management.h"
 
 /* names for the scheduling and memory strategies */
-const char *const scheduler_str[] = {[SJF] = "SJF", [RR] = "RR"};
+const char *const scheduler_str[] = 
+        {[SJF] = "SJF", [RR] = "RR", [MSJF] = "MSJF", [SRTF] = "SRTF",
+         [MLFQ] = "MLFQ", [CFS] = "CFS"};
 const char *const memory_strategy_str[] = 
-        {[INFINITE] = "infinite", [BEST_FIT] = "best-fit"};
+        {[INFINITE] = "infinite", [BEST_FIT] = "best-fit", [BUDDY] = "buddy", 
+         [FIRST_FIT] = "first-fit", [NEXT_FIT] = "next-fit", 
+         [WORST_FIT] = "worst-fit", [BITMAP] = "bitmap",
+         [VIRTUAL] = "virtual", [TLSF] = "tlsf", [SLAB] = "slab"};
+const char *const memory_map_str[] = 
+        {[LIST_MAP] = "list", [ARRAY_MAP] = "array"};
+const char *const placement_str[] = 
+        {[LOCAL_FIRST] = "local", [LEAST_LOADED] = "least-loaded", 
+         [BEST_FIT_BANK] = "best-fit"};
+const char *const admission_str[] = 
+        {[ARRIVAL_ORDER] = "fifo", [LARGEST_FIRST] = "largest-first", 
+         [BEST_PACK] = "best-pack"};
 
 /* functions for the scheduling and memory strategies */
 const scheduler_fp_t scheduler_func[] = 
-        {[SJF] = shortest_job_first, [RR] = round_robin};
+        {[SJF] = shortest_job_first, [RR] = round_robin, 
+         [MSJF] = memory_aware_sjf, [SRTF] = shortest_remaining_time_first,
+         [MLFQ] = multilevel_feedback_queue, [CFS] = completely_fair};
 const memory_strategy_fp_t memory_strategy_func[] = 
-        {[INFINITE] = infinite_malloc, [BEST_FIT] = best_fit_malloc};
+        {[INFINITE] = infinite_malloc, [BEST_FIT] = best_fit_malloc, 
+         [BUDDY] = buddy_malloc, [FIRST_FIT] = first_fit_malloc, 
+         [NEXT_FIT] = next_fit_malloc, [WORST_FIT] = worst_fit_malloc, 
+         [BITMAP] = bitmap_malloc, [VIRTUAL] = virtual_malloc, 
+         [TLSF] = tlsf_malloc, [SLAB] = slab_malloc};
+/* how memory is carved up under each memory strategy */
+const enum memory_allocator memory_strategy_allocator[] = 
+        {[INFINITE] = SEGMENT_ALLOCATOR, [BEST_FIT] = SEGMENT_ALLOCATOR, 
+         [BUDDY] = BUDDY_ALLOCATOR, [FIRST_FIT] = SEGMENT_ALLOCATOR, 
+         [NEXT_FIT] = SEGMENT_ALLOCATOR, [WORST_FIT] = SEGMENT_ALLOCATOR, 
+         [BITMAP] = BITMAP_ALLOCATOR, [VIRTUAL] = VIRTUAL_ALLOCATOR, 
+         [TLSF] = SEGMENT_ALLOCATOR, [SLAB] = SEGMENT_ALLOCATOR};
+/* how a process is allocated memory under each memory strategy
+   (where it is allocated a contiguous block) */
+const process_allocator_fp_t process_allocator_func[] = 
+        {[INFINITE] = NULL, [BEST_FIT] = malloc_by_best_fit, 
+         [BUDDY] = malloc_by_buddy, [FIRST_FIT] = malloc_by_first_fit, 
+         [NEXT_FIT] = malloc_by_next_fit, [WORST_FIT] = malloc_by_worst_fit,
+         [BITMAP] = malloc_by_bitmap, [VIRTUAL] = NULL, 
+         [TLSF] = malloc_by_tlsf, [SLAB] = malloc_by_slab};
 
 /* for the transcript */
 const char *const process_state_str[] = 
         {[FINISHED] = "FINISHED", [FINISHED_PROCESS] = "FINISHED-PROCESS", 
-         [READY] = "READY", [RUNNING] = "RUNNING"};
+         [READY] = "READY", [RUNNING] = "RUNNING", 
+         [SWAPPED_OUT] = "SWAPPED-OUT", [SWAPPED_IN] = "SWAPPED-IN"};
+
+/* a process waiting for admission, and its place in the input queue */
+typedef struct {
+    node_t *node;
+    int position;
+    int packed;     // chosen to fill the largest hole (under best-pack)
+} waiting_t;
+
+/* position in the ready processes of all cores (in a queue, or heap) */
+typedef struct {
+    int core;
+    int queue;      // of the core
+    int index;
+    node_t *node;   // the last visited, in a queue
+} ready_iter_t;
 
 /* some 'private' helper functions */
 static double round_to_two_dp(double d);
 static uint32_t uint_safe_subtract(uint32_t u1, uint32_t u2);
-static node_t *find_shortest_job(queue_t *ready_queue);
+static int cmp_shortest_job(void *p1, void *p2);
+static int cmp_remaining_time(void *p1, void *p2);
+static int cmp_vruntime(void *p1, void *p2);
+static void preempt(process_manager_t *manager, core_t *core);
+static int highest_ready_level(core_t *core);
+static void boost_priorities(process_manager_t *manager);
+static void update_min_vruntime(core_t *core, process_t *running);
+static void make_ready(process_manager_t *manager, core_t *core, 
+        process_t *process, node_t *node);
+static void add_ready(core_t *core, process_t *process, node_t *node);
+static int count_ready(core_t *core);
+static queue_t *core_queue(core_t *core, int i);
+static core_t *least_busy_core(process_manager_t *manager);
+static void steal_work(process_manager_t *manager, core_t *core);
+static process_t *next_ready(process_manager_t *manager, ready_iter_t *iter);
+static void check_requirements(process_manager_t *manager);
+static node_t *find_memory_aware_job(process_manager_t *manager, 
+        core_t *core);
+static mem_addr_t smallest_waiting(process_manager_t *manager);
+static void admit_processes(process_manager_t *manager, 
+        process_allocator_fp_t allocate);
+static int admit_process(process_manager_t *manager, process_t *process, 
+        process_allocator_fp_t allocate);
+static void admit_in_order(process_manager_t *manager, 
+        process_allocator_fp_t allocate);
+static void order_admissions(process_manager_t *manager, waiting_t *waiting, 
+        waiting_t *order, int count);
+static void pack_hole(process_manager_t *manager, waiting_t *waiting, 
+        int count, mem_addr_t hole);
+static void skip_idle_cycles(process_manager_t *manager);
+static int cmp_by_size_desc(const void *w1, const void *w2);
+static void try_allocate(process_manager_t *manager, process_t *process, 
+        process_allocator_fp_t allocate);
+static int choose_bank(process_manager_t *manager, process_t *process);
+static int compact_bank(process_manager_t *manager, process_t *process);
+static void update_bank(process_manager_t *manager, int bank);
+static mem_addr_t total_free(process_manager_t *manager);
+static int swapped_out(process_t *process);
+static mem_addr_t swappable_memory(process_manager_t *manager);
+static process_t **held_longest_first(process_manager_t *manager,
+        int *count);
+static int cmp_time_held(const void *p1, const void *p2);
+static int held_before(process_t *process1, process_t *process2);
+static int held_no_later(process_t *process, void *context);
+static int any_running(process_manager_t *manager);
+static void swap_out(process_manager_t *manager, process_t *process, 
+        process_t *room_for);
+static void swap_out_for(process_manager_t *manager, process_t *process, 
+        process_allocator_fp_t allocate);
+static void swap_out_until_fits(process_manager_t *manager,
+        process_t *process, process_allocator_fp_t allocate);
+static int swap_in(process_manager_t *manager, process_t *process);
+static void complete_process(process_manager_t *manager, core_t *core);
+static void schedule_on_core(process_manager_t *manager, core_t *core);
 
 
-/* Creates, initializes, and returns a process manager.
+/* Creates, initializes, and returns a process manager,
+   configured by the given options.
  */
-process_manager_t *create_manager(FILE *f, char *scheduler, 
-        char *memory_strategy, int quantum) {
-    assert(f && scheduler && memory_strategy);
+process_manager_t *create_manager(FILE *f, manager_config_t *config) {
+    assert(f && config && config->scheduler && config->memory_strategy);
 
     process_manager_t *manager = malloc(sizeof(*manager));
     assert(manager);
 
-    manager->quantum = quantum;
+    manager->quantum = config->quantum;
+    manager->swap_penalty = config->swap_penalty;
     manager->unsubmitted_queue = build_queue(f); // load the processes
     manager->input_queue = make_empty_queue();
-    manager->ready_queue = make_empty_queue();
+    manager->cores = NULL;
+    manager->num_cores = 0;
+    manager->next_ready_order = 0;
+    manager->num_levels = 0;
+    manager->boost_period = manager->next_boost = NO_BOOST;
 
-    manager->running_process = NULL;
-    manager->memory = initialize_memory();
+    manager->banks = NULL;
+    manager->num_banks = 0;
+    manager->next_home = 0;
     manager->current_sim_time = 0;
+    manager->admission_pending = 0;
+    manager->swap_allocator = NULL;
+    manager->swap_out_latency = manager->swap_in_latency = 0;
+    manager->num_swap_outs = manager->num_swap_ins = 0;
+    manager->swap_traffic = 0;
 
     manager->total_turnaround_time = 0;
     manager->num_process = manager->unsubmitted_queue->count;
@@ -60,9 +174,10 @@ process_manager_t *create_manager(FILE *f, char *scheduler,
     /* Assign the algorithms */
     manager->scheduler = NULL;
     manager->malloc_strategy = NULL;
+    enum memory_allocator allocator = SEGMENT_ALLOCATOR;
 
-    for (int i = SJF; i <= RR; i++) {
-        if (strcmp(scheduler, scheduler_str[i]) == 0) {
+    for (int i = SJF; i <= CFS; i++) {
+        if (strcmp(config->scheduler, scheduler_str[i]) == 0) {
             manager->scheduler = scheduler_func[i];
         }
     }
@@ -71,9 +186,16 @@ process_manager_t *create_manager(FILE *f, char *scheduler,
         exit(EXIT_FAILURE);
     }
 
-    for (int i = INFINITE; i <= BEST_FIT; i++) {
-        if (strcmp(memory_strategy, memory_strategy_str[i]) == 0) {
+    for (int i = INFINITE; i <= SLAB; i++) {
+        if (strcmp(config->memory_strategy, memory_strategy_str[i]) == 0) {
             manager->malloc_strategy = memory_strategy_func[i];
+            allocator = memory_strategy_allocator[i];
+            if (config->swap_out_latency != NO_SWAPPING) {
+                // (only processes holding contiguous memory are swapped)
+                manager->swap_allocator = process_allocator_func[i];
+                manager->swap_out_latency = config->swap_out_latency;
+                manager->swap_in_latency = config->swap_in_latency;
+            }
         }
     }
     if (!manager->malloc_strategy) {
@@ -81,9 +203,157 @@ process_manager_t *create_manager(FILE *f, char *scheduler,
         exit(EXIT_FAILURE);
     }
 
+    int placement = NO_BANK;
+    for (int i = LOCAL_FIRST; i <= BEST_FIT_BANK; i++) {
+        if (strcmp(config->placement, placement_str[i]) == 0)
+            placement = i;
+    }
+    if (placement == NO_BANK) {
+        perror("Invalid placement policy");
+        exit(EXIT_FAILURE);
+    }
+    manager->placement = placement;
+
+    int admission = -1;
+    for (int i = ARRIVAL_ORDER; i <= BEST_PACK; i++) {
+        if (strcmp(config->admission, admission_str[i]) == 0)
+            admission = i;
+    }
+    if (admission == -1) {
+        perror("Invalid admission policy");
+        exit(EXIT_FAILURE);
+    }
+    manager->admission = admission;
+    manager->pack_last = NULL;
+    if (admission == BEST_PACK) { // a total per size up to the largest hole
+        manager->pack_last = 
+                malloc((MAX_PACKED_HOLE + 1) * sizeof(*manager->pack_last));
+        assert(manager->pack_last);
+    }
+
+    /* Set up the priority levels (used under MLFQ) */
+    assert(config->num_levels >= 0 && config->num_levels <= MAX_LEVELS);
+    manager->num_levels = 
+            config->num_levels ? config->num_levels : DEFAULT_NUM_LEVELS;
+    for (int i = 0; i < manager->num_levels; i++) {
+        manager->level_quanta[i] = 
+                config->num_levels ? config->level_quanta[i] : 1 << i;
+    }
+    manager->boost_period = manager->next_boost = config->boost_period;
+
+    /* Build the cores */
+    assert(config->num_cores >= 1 && config->num_cores <= MAX_CORES);
+    manager->num_cores = config->num_cores;
+    manager->cores = malloc(manager->num_cores * sizeof(*manager->cores));
+    assert(manager->cores);
+    for (int i = 0; i < manager->num_cores; i++) {
+        core_t *core = &manager->cores[i];
+        core->id = i;
+        core->running_process = NULL;
+        core->ready_queue = make_empty_queue();
+        core->ready_heap = NULL;
+        if (manager->scheduler == shortest_job_first) 
+            // ready processes kept in order of service time
+            core->ready_heap = make_empty_heap(cmp_shortest_job);
+        else if (manager->scheduler == shortest_remaining_time_first)
+            // ... or of remaining time
+            core->ready_heap = make_empty_heap(cmp_remaining_time);
+        else if (manager->scheduler == completely_fair)
+            // ... or of virtual runtime
+            core->ready_heap = make_empty_heap(cmp_vruntime);
+        core->fair = manager->scheduler == completely_fair;
+        core->min_vruntime = 0;
+        core->num_levels = 0;
+        if (manager->scheduler == multilevel_feedback_queue) {
+            core->num_levels = manager->num_levels;
+            for (int l = 0; l < core->num_levels; l++)
+                core->levels[l] = make_empty_queue();
+        }
+        core->slice_left = 0;
+        core->stalled = 0;
+        core->busy_time = 0;
+        core->num_steals = 0;
+    }
+
+    /* Build the memory banks (a single bank, unless given) */
+    int map_type = -1;
+    for (int i = LIST_MAP; i <= ARRAY_MAP; i++) {
+        if (strcmp(config->memory_map, memory_map_str[i]) == 0)
+            map_type = i;
+    }
+    if (map_type == -1) {
+        perror("Invalid memory map");
+        exit(EXIT_FAILURE);
+    }
+    assert(config->num_banks >= 0 && config->num_banks <= MAX_BANKS);
+    manager->num_banks = config->num_banks ? config->num_banks : 1;
+    const mem_addr_t *capacities = config->num_banks ? 
+            config->bank_capacities : &config->memory_capacity;
+    manager->banks = malloc(manager->num_banks * sizeof(*manager->banks));
+    manager->bank_bases = 
+            malloc(manager->num_banks * sizeof(*manager->bank_bases));
+    manager->bank_largest = 
+            malloc(manager->num_banks * sizeof(*manager->bank_largest));
+    assert(manager->banks && manager->bank_bases && manager->bank_largest);
+
+    mem_addr_t base = 0;
+    for (int i = 0; i < manager->num_banks; i++) {
+        memory_t *bank = initialize_memory(allocator, map_type, 
+                capacities[i]);
+        if (config->compaction_threshold != NO_COMPACTION)
+            enable_compaction(bank, config->compaction_threshold);
+        if (manager->malloc_strategy == tlsf_malloc)
+            enable_tlsf(bank);
+        if (manager->malloc_strategy == slab_malloc)
+            enable_slab(bank);
+        if (manager->malloc_strategy == first_fit_malloc 
+                || manager->malloc_strategy == next_fit_malloc)
+            enable_hole_array(bank);
+        manager->banks[i] = bank;
+        manager->bank_bases[i] = base; // banks laid out one after another
+        base += capacities[i];
+        update_bank(manager, i);
+    }
+    check_requirements(manager);
+
+    manager->memory_stats = NULL;
+    if (config->stats_file) {
+        FILE *series = fopen(config->stats_file, "w");
+        if (!series) {
+            perror("Invalid statistics file");
+            exit(EXIT_FAILURE);
+        }
+        manager->memory_stats = create_memory_stats(series);
+    }
+
     return manager;
 }
 
+/* Helper function to exit with an error if a process requires more memory
+   than could ever be allocated to it: more than the largest block
+   allocatable in any (still empty) bank, after the allocator's rounding,
+   as a process is allocated memory within a single bank.
+ */
+static void check_requirements(process_manager_t *manager) {
+    if (manager->malloc_strategy == infinite_malloc) // anything fits
+        return;
+    mem_addr_t limit = 0;
+    for (int i = 0; i < manager->num_banks; i++) {
+        if (manager->bank_largest[i] > limit)
+            limit = manager->bank_largest[i];
+    }
+
+    node_t *curr = manager->unsubmitted_queue->head;
+    for (; curr; curr = curr->next) {
+        if (((process_t *) curr->data)->memory_requirement > limit) {
+            perror(manager->num_banks > 1
+                    ? "Invalid memory requirement (larger than any bank)"
+                    : "Invalid memory requirement (larger than memory)");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
 /* Submits processes (moves processes from the unsubmitted 
    queue to the input queue in the manager).
  */
@@ -97,6 +367,10 @@ void submit_processes(process_manager_t *manager) {
         // move arrived processes to the input queue
         dequeue(manager->unsubmitted_queue);
         enqueue(manager->input_queue, curr);
+        // spread the arrivals over the banks, like threads over nodes
+        ((process_t *) curr->data)->bank = manager->next_home;
+        manager->next_home = (manager->next_home + 1) % manager->num_banks;
+        manager->admission_pending = 1;
     }
 }
 
@@ -108,34 +382,100 @@ void infinite_malloc(process_manager_t *manager) {
     if (is_empty_queue(manager->input_queue)) // no process to malloc
         return;
 
-    // move all processes in the input queue to the ready queue
-    manager->ready_queue = 
-            append_queue(manager->ready_queue, manager->input_queue);
+    // move all processes in the input queue to the ready processes
+    node_t *node;
+    while ((node = dequeue(manager->input_queue)))
+        make_ready(manager, NULL, node->data, node);
 }
 
 /* Manager allocates memory by best fit to submitted processes.
  */
 void best_fit_malloc(process_manager_t *manager) {
-    assert(manager);
-    if (is_empty_queue(manager->input_queue)) // no process to malloc
+    admit_processes(manager, malloc_by_best_fit);
+}
+
+/* Manager allocates memory by the buddy system to submitted processes.
+ */
+void buddy_malloc(process_manager_t *manager) {
+    admit_processes(manager, malloc_by_buddy);
+}
+
+/* Manager allocates memory by first fit to submitted processes.
+ */
+void first_fit_malloc(process_manager_t *manager) {
+    admit_processes(manager, malloc_by_first_fit);
+}
+
+/* Manager allocates memory by next fit to submitted processes.
+ */
+void next_fit_malloc(process_manager_t *manager) {
+    admit_processes(manager, malloc_by_next_fit);
+}
+
+/* Manager allocates memory by worst fit to submitted processes.
+ */
+void worst_fit_malloc(process_manager_t *manager) {
+    admit_processes(manager, malloc_by_worst_fit);
+}
+
+/* Manager allocates memory as runs of pages to submitted processes.
+ */
+void bitmap_malloc(process_manager_t *manager) {
+    admit_processes(manager, malloc_by_bitmap);
+}
+
+/* Manager allocates memory by two-level segregated fit 
+   to submitted processes.
+ */
+void tlsf_malloc(process_manager_t *manager) {
+    admit_processes(manager, malloc_by_tlsf);
+}
+
+/* Manager allocates memory from slabs for recurring sizes 
+   to submitted processes.
+ */
+void slab_malloc(process_manager_t *manager) {
+    admit_processes(manager, malloc_by_slab);
+}
+
+/* Manager allocates virtual memory (pages, not all in memory) 
+   to submitted processes.
+ */
+void virtual_malloc(process_manager_t *manager) {
+    admit_processes(manager, malloc_by_virtual);
+}
+
+/* Helper function to try allocating memory to each submitted process 
+   with the given allocator, in the order given by the admission policy
+   (arrival order by default), moving those allocated to the ready queue.
+ * Only runs when memory was freed or processes arrived since the last time,
+   as the processes still waiting could not fit then (unless swapping, 
+   where READY processes can be swapped out to make room).
+ */
+static void admit_processes(process_manager_t *manager, 
+        process_allocator_fp_t allocate) {
+    assert(manager && allocate);
+    if (is_empty_queue(manager->input_queue) // no process to malloc
+            || !manager->admission_pending)  // nothing changed
         return;
+    manager->admission_pending = 0;
+    if (manager->admission != ARRIVAL_ORDER) {
+        admit_in_order(manager, allocate);
+        return;
+    }
 
     node_t *curr = manager->input_queue->head;
     node_t *prev = NULL;
     process_t *curr_process;
     while (curr) {
         curr_process = (process_t *) curr->data;
-        malloc_by_best_fit(manager->memory, curr_process);
-        if (curr_process->address_assigned != NOT_ASSIGNED 
-                && curr_process->state != READY) {
-            // memory successfully allocated
-            curr_process->state = READY;
+        if (admit_process(manager, curr_process, allocate)) {
             // store the next node before deletion
             node_t *node_to_move = curr;
             curr = curr->next; // `prev` remains
             // move from input to ready queue
-            move_between_queues(manager->input_queue, manager->ready_queue, 
-                    node_to_move, prev);
+            delete_node_from_queue(prev, node_to_move, manager->input_queue);
+            make_ready(manager, NULL, curr_process, node_to_move);
             print_transcript(manager, curr_process, READY);
 
         } else {
@@ -145,89 +485,636 @@ void best_fit_malloc(process_manager_t *manager) {
     }
 }
 
-/* Helper function to find and return the node for the shortest ready process.
- * Returns NULL if there are no more ready processes.
+/* Helper function to try allocating memory to the (submitted) process 
+   with the given allocator, swapping out READY processes to make room
+   if swapping, and make it READY if allocated.
+ * Returns TRUE (1) if it was allocated memory, FALSE (0) otherwise.
  */
-static node_t *find_shortest_job(queue_t *ready_queue) {
-    if (is_empty_queue(ready_queue)) // no ready processes available
-        return NULL;
+static int admit_process(process_manager_t *manager, process_t *process, 
+        process_allocator_fp_t allocate) {
+    try_allocate(manager, process, allocate);
+    if (process->address_assigned == NOT_ASSIGNED 
+            && manager->swap_allocator 
+            && process->memory_requirement 
+                    <= total_free(manager) + swappable_memory(manager)) {
+        swap_out_for(manager, process, allocate);
+    }
+    if (process->address_assigned == NOT_ASSIGNED)
+        return 0;
+
+    // memory successfully allocated
+    process->state = READY;
+    process->time_loaded = manager->current_sim_time;
+    return 1;
+}
+
+/* Helper function to try allocating memory to the submitted processes
+   with the given allocator, in the order given by the admission policy,
+   moving those allocated to the ready queue (in the order allocated).
+ */
+static void admit_in_order(process_manager_t *manager, 
+        process_allocator_fp_t allocate) {
+    int count = manager->input_queue->count;
+    waiting_t *waiting = malloc(count * sizeof(*waiting));
+    waiting_t *order = malloc(count * sizeof(*order));
+    assert(waiting && order);
+    // take all waiting processes out of the input queue
+    for (int i = 0; i < count; i++) {
+        waiting[i].node = dequeue(manager->input_queue);
+        waiting[i].position = i;
+        waiting[i].packed = 0;
+    }
+    order_admissions(manager, waiting, order, count);
+
+    for (int i = 0; i < count; i++) {
+        process_t *process = order[i].node->data;
+        if (admit_process(manager, process, allocate)) {
+            make_ready(manager, NULL, process, order[i].node);
+            print_transcript(manager, process, READY);
+            waiting[order[i].position].node = NULL;
+        }
+    }
+
+    // the rest wait on, in arrival order
+    for (int i = 0; i < count; i++) {
+        if (waiting[i].node)
+            enqueue(manager->input_queue, waiting[i].node);
+    }
+    free(waiting);
+    waiting = NULL;
+    free(order);
+    order = NULL;
+}
+
+/* Helper function to arrange the `count` waiting processes (in arrival 
+   order) into `order`, the order they are tried in under the admission
+   policy:
+   - largest first: by memory requirement, largest first (then in arrival
+     order);
+   - best pack: the combination of processes (of the earliest 
+     MAX_PACKED_PROCESSES) that fills the largest hole the most, then the
+     others (each in arrival order).
+ * Best pack falls back to largest first when the hole is too large to 
+   search (over MAX_PACKED_HOLE).
+ */
+static void order_admissions(process_manager_t *manager, waiting_t *waiting, 
+        waiting_t *order, int count) {
+    mem_addr_t hole = 0; // the largest, over all banks
+    for (int i = 0; i < manager->num_banks; i++) {
+        if (manager->bank_largest[i] > hole)
+            hole = manager->bank_largest[i];
+    }
+
+    if (manager->admission == LARGEST_FIRST || hole > MAX_PACKED_HOLE) {
+        memcpy(order, waiting, count * sizeof(*order));
+        qsort(order, count, sizeof(*order), cmp_by_size_desc);
+        return;
+    }
 
-    node_t *curr = ready_queue->head;
-    node_t *shortest_job = curr;
-    // node-deletion requires the previous node in a (singly-linked) queue
-    node_t *shortest_job_prev = NULL;
-
-    while (curr->next) { // linear search
-        if (cmp_by_service_time(curr->next->data, shortest_job->data) < 0) {
-            shortest_job = curr->next;
-            shortest_job_prev = curr;
-        } else if (cmp_by_service_time(curr->next->data, 
-                shortest_job->data) == 0) { // same service time
-            if (cmp_by_time_arrived(curr->next->data, shortest_job->data) < 0) {
-                // take the one that arrived earlier
-                shortest_job = curr->next;
-                shortest_job_prev = curr;
-            } else if (cmp_by_time_arrived(curr->next->data, 
-                    shortest_job->data) == 0 
-                    && cmp_by_name(curr->next->data, shortest_job->data) < 0) {
-                // same arrival time
-                // take the one whose name comes first lexicographically
-                shortest_job = curr->next;
-                shortest_job_prev = curr;
+    pack_hole(manager, waiting, count, hole);
+    int next = 0;
+    for (int i = 0; i < count; i++) {
+        if (waiting[i].packed)
+            order[next++] = waiting[i];
+    }
+    for (int i = 0; i < count; i++) {
+        if (!waiting[i].packed)
+            order[next++] = waiting[i];
+    }
+}
+
+/* Helper function to mark (as `packed`) the combination of the `count` 
+   waiting processes (the earliest MAX_PACKED_PROCESSES of them) whose 
+   total memory requirement fills the hole of the given size the most, by
+   dynamic programming over the totals up to it (or up to their sum).
+ */
+static void pack_hole(process_manager_t *manager, waiting_t *waiting, 
+        int count, mem_addr_t hole) {
+    if (count > MAX_PACKED_PROCESSES)
+        count = MAX_PACKED_PROCESSES;
+    mem_addr_t sum = 0;
+    for (int i = 0; i < count; i++) {
+        mem_addr_t size = 
+                ((process_t *) waiting[i].node->data)->memory_requirement;
+        if (size > 0 && size <= hole)
+            sum += size;
+    }
+    if (sum <= hole) { // all of them fit: no search needed
+        for (int i = 0; i < count; i++) {
+            mem_addr_t size = 
+                    ((process_t *) waiting[i].node->data)->memory_requirement;
+            waiting[i].packed = size > 0 && size <= hole;
+        }
+        return;
+    }
+
+    // last[s]: the last process in a combination totalling s, or -1 if no 
+    // combination does (the empty combination is marked by `count`)
+    // (filled in only up to the totals reachable so far)
+    int *last = manager->pack_last;
+    last[0] = count;
+
+    mem_addr_t best = 0, reached = 0;
+    for (int i = 0; i < count && best < hole; i++) {
+        mem_addr_t size = 
+                ((process_t *) waiting[i].node->data)->memory_requirement;
+        if (size <= 0 || size > hole)
+            continue;
+        mem_addr_t prev = reached;
+        reached = reached + size < hole ? reached + size : hole;
+        for (mem_addr_t s = prev + 1; s <= reached; s++)
+            last[s] = -1;
+        // downwards, so that each process is used at most once
+        for (mem_addr_t s = reached; s >= size; s--) {
+            if (last[s] == -1 && last[s - size] != -1) {
+                last[s] = i;
+                if (s > best)
+                    best = s;
             }
         }
-        curr = curr->next;
     }
 
-    delete_node_from_queue(shortest_job_prev, shortest_job, ready_queue);
+    // each total was first reached by adding a later process than the
+    // ones making up the rest of it
+    for (mem_addr_t s = best; s > 0; ) {
+        int i = last[s];
+        waiting[i].packed = 1;
+        s -= ((process_t *) waiting[i].node->data)->memory_requirement;
+    }
+}
+
+/* Helper function to compare two waiting processes for `qsort`: 
+   the larger memory requirement first, then the earlier in the queue.
+ */
+static int cmp_by_size_desc(const void *w1, const void *w2) {
+    const waiting_t *waiting1 = w1, *waiting2 = w2;
+    int cmp = cmp_by_memory_requirement(waiting2->node->data, 
+            waiting1->node->data);
+    if (cmp)
+        return cmp;
+    return waiting1->position - waiting2->position;
+}
+
+/* Helper function to allocate memory to the process with the given 
+   allocator, in the bank chosen by the placement policy, if a hole fits
+   it in some bank (possibly after compaction).
+ * Only the chosen bank is searched.
+ */
+static void try_allocate(process_manager_t *manager, process_t *process, 
+        process_allocator_fp_t allocate) {
+    int bank = choose_bank(manager, process);
+    if (bank == NO_BANK)
+        bank = compact_bank(manager, process);
+    if (bank == NO_BANK) // no hole fits: skip the search
+        return;
+
+    allocate(manager->banks[bank], process);
+    if (process->address_assigned != NOT_ASSIGNED)
+        process->bank = bank;
+    update_bank(manager, bank);
+}
+
+/* Helper function to return the bank to allocate memory to the process in,
+   among those with a hole that fits it, as chosen by the placement policy:
+   its own bank if possible (then the banks following it), the bank with 
+   the most free memory for its capacity, or the bank with the smallest
+   hole that fits it.
+ * Returns NO_BANK if no hole fits it.
+ */
+static int choose_bank(process_manager_t *manager, process_t *process) {
+    int chosen = NO_BANK;
+    for (int i = 0; i < manager->num_banks; i++) {
+        int bank = (process->bank + i) % manager->num_banks;
+        if (process->memory_requirement > manager->bank_largest[bank])
+            continue;
+
+        switch (manager->placement) {
+            case LOCAL_FIRST:
+                return bank;
+            case LEAST_LOADED:
+                // compare the free shares, scaled to avoid division
+                if (chosen == NO_BANK || (double) manager->banks[bank]->free 
+                        * manager->banks[chosen]->capacity 
+                        > (double) manager->banks[chosen]->free 
+                        * manager->banks[bank]->capacity)
+                    chosen = bank;
+                break;
+            case BEST_FIT_BANK:
+                if (chosen == NO_BANK || manager->bank_largest[bank] 
+                        < manager->bank_largest[chosen])
+                    chosen = bank;
+                break;
+        }
+    }
+    return chosen;
+}
+
+/* Helper function to compact the first bank (from the process's own bank)
+   where that makes room for the process, and return it.
+ * Returns NO_BANK if no bank is compacted.
+ */
+static int compact_bank(process_manager_t *manager, process_t *process) {
+    for (int i = 0; i < manager->num_banks; i++) {
+        int bank = (process->bank + i) % manager->num_banks;
+        if (compact_if_fragmented(manager->banks[bank], 
+                process->memory_requirement)) {
+            update_bank(manager, bank);
+            return bank;
+        }
+    }
+    return NO_BANK;
+}
+
+/* Helper function to record the largest block allocatable in the bank,
+   after its memory changes.
+ */
+static void update_bank(process_manager_t *manager, int bank) {
+    manager->bank_largest[bank] = largest_allocatable(manager->banks[bank]);
+}
 
-    return shortest_job;
+/* Helper function to return the total free memory over all banks.
+ */
+static mem_addr_t total_free(process_manager_t *manager) {
+    mem_addr_t free = 0;
+    for (int i = 0; i < manager->num_banks; i++)
+        free += manager->banks[i]->free;
+    return free;
 }
 
-/* Returns the next process to run, 
+/* Helper function to return TRUE (1) if the (READY) process is swapped out,
+   FALSE (0) otherwise.
+ * Only meaningful when swapping (processes are never allocated memory 
+   under infinite memory).
+ */
+static int swapped_out(process_t *process) {
+    return process->state == READY 
+            && process->address_assigned == NOT_ASSIGNED;
+}
+
+/* Helper function to return the total memory required by the READY 
+   processes in memory.
+ */
+static mem_addr_t swappable_memory(process_manager_t *manager) {
+    mem_addr_t total = 0;
+    ready_iter_t iter = {0, 0, 0, NULL};
+    process_t *process;
+    while ((process = next_ready(manager, &iter))) {
+        if (!swapped_out(process))
+            total += process->memory_requirement;
+    }
+    return total;
+}
+
+/* Helper function to return (in a new array) the READY processes in
+   memory, those that have held memory the longest first (the first to
+   become ready on ties), storing their number in `count`.
+ */
+static process_t **held_longest_first(process_manager_t *manager,
+        int *count) {
+    process_t **held =
+            malloc((count_waiting_processes(manager) + 1) * sizeof(*held));
+    assert(held);
+    *count = 0;
+    ready_iter_t iter = {0, 0, 0, NULL};
+    process_t *process;
+    while ((process = next_ready(manager, &iter))) {
+        if (!swapped_out(process))
+            held[(*count)++] = process;
+    }
+    qsort(held, *count, sizeof(*held), cmp_time_held);
+    return held;
+}
+
+/* Helper function to compare two processes (given by pointers to them)
+   by how long they have held memory, for `qsort`.
+ */
+static int cmp_time_held(const void *p1, const void *p2) {
+    process_t *process1 = *(process_t **) p1, *process2 = *(process_t **) p2;
+    if (held_before(process1, process2))
+        return -1;
+    return held_before(process2, process1);
+}
+
+/* Helper function to return TRUE (1) if the first process has held memory
+   longer than the second (being loaded earlier, or becoming ready first on
+   ties), FALSE (0) otherwise.
+ */
+static int held_before(process_t *process1, process_t *process2) {
+    if (process1->time_loaded != process2->time_loaded)
+        return process1->time_loaded < process2->time_loaded;
+    return process1->ready_order < process2->ready_order;
+}
+
+/* Helper function to return TRUE (1) if the process is READY and has held
+   memory no shorter than the given one (the context), FALSE (0) otherwise.
+ */
+static int held_no_later(process_t *process, void *context) {
+    return process->state == READY
+            && !held_before((process_t *) context, process);
+}
+
+/* Helper function to return TRUE (1) if a process is running on any core,
+   FALSE (0) otherwise.
+ */
+static int any_running(process_manager_t *manager) {
+    for (int i = 0; i < manager->num_cores; i++) {
+        process_t *running = manager->cores[i].running_process;
+        if (running && running->state == RUNNING) // (not just preempted)
+            return 1;
+    }
+    return 0;
+}
+
+/* Helper function to swap the (READY) process out to disk, 
+   freeing its memory to make room for the other process, whose core 
+   idles while it is written out.
+ */
+static void swap_out(process_manager_t *manager, process_t *process, 
+        process_t *room_for) {
+    print_transcript(manager, process, SWAPPED_OUT);
+    demalloc(process, manager->banks[process->bank]);
+    update_bank(manager, process->bank);
+    process->address_assigned = NOT_ASSIGNED;
+    manager->admission_pending = 1;
+
+    manager->num_swap_outs++;
+    manager->swap_traffic += process->memory_requirement;
+    room_for->stall_left += manager->swap_out_latency;
+}
+
+/* Helper function to swap out READY processes that have held memory
+   the longest to make room for the process (to be allocated memory with
+   the given allocator), but only where that is known to leave a block
+   holding it: the fewest of them whose release would, and of those, the
+   ones in that block.
+ * If there are none, they stay in memory.
+ */
+static void swap_out_for(process_manager_t *manager, process_t *process, 
+        process_allocator_fp_t allocate) {
+    if (process->address_assigned != NOT_ASSIGNED) // already fits
+        return;
+    int count;
+    process_t **held = held_longest_first(manager, &count);
+    int last = -1;
+    mem_addr_t start = 0, length = 0;
+    for (int i = 0; i < count && last == -1; i++) {
+        length = block_if_freed(manager->banks[held[i]->bank], held[i],
+                held_no_later, held[i], &start);
+        if (length >= process->memory_requirement)
+            last = i;
+    }
+
+    if (last != -1) {
+        int bank = held[last]->bank;
+        for (int i = 0; i <= last; i++) {
+            if (held[i]->bank == bank && held[i]->address_assigned >= start
+                    && held[i]->address_assigned < start + length)
+                swap_out(manager, held[i], process);
+        }
+        try_allocate(manager, process, allocate);
+    }
+    free(held);
+}
+
+/* Helper function to swap out the READY processes that have held memory
+   the longest, until the process can be allocated memory with the given
+   allocator (or no READY process is left in memory).
+ */
+static void swap_out_until_fits(process_manager_t *manager,
+        process_t *process, process_allocator_fp_t allocate) {
+    int count;
+    process_t **held = held_longest_first(manager, &count);
+    for (int i = 0; i < count
+            && process->address_assigned == NOT_ASSIGNED; i++) {
+        swap_out(manager, held[i], process);
+        try_allocate(manager, process, allocate);
+    }
+    free(held);
+}
+
+/* Helper function to swap the (swapped out) process back into memory, 
+   swapping out others as needed.
+ * Returns FALSE (0) if it still does not fit, with the rest of memory 
+   held by processes running on other cores, TRUE (1) otherwise.
+ */
+static int swap_in(process_manager_t *manager, process_t *process) {
+    try_allocate(manager, process, manager->swap_allocator);
+    swap_out_for(manager, process, manager->swap_allocator);
+    if (process->address_assigned == NOT_ASSIGNED) {
+        // (never with a single core, as its process was just suspended)
+        if (any_running(manager))
+            return 0;
+        // nothing else would free memory (under the buddy or bitmap
+        // allocator, or with slabs, a block is not always foreseen)
+        swap_out_until_fits(manager, process, manager->swap_allocator);
+        // with none running, all processes in memory are READY, so at worst
+        // memory is emptied, and any process fits (see check_requirements)
+        assert(process->address_assigned != NOT_ASSIGNED);
+    }
+
+    process->time_loaded = manager->current_sim_time;
+    print_transcript(manager, process, SWAPPED_IN);
+    manager->num_swap_ins++;
+    manager->swap_traffic += process->memory_requirement;
+    process->stall_left += manager->swap_in_latency;
+    return 1;
+}
+
+/* Helper function to compare two processes by the order they run in
+   under SJF: by service time, then arrival time, then name.
+ */
+static int cmp_shortest_job(void *p1, void *p2) {
+    return cmp_by_order_key(p1, p2); // packed when the process was read
+}
+
+/* Helper function to compare two processes by the order they run in
+   under SRTF: by remaining time, then as under SJF.
+ */
+static int cmp_remaining_time(void *p1, void *p2) {
+    process_t *process1 = p1, *process2 = p2;
+    if (process1->time_remaining != process2->time_remaining)
+        return process1->time_remaining < process2->time_remaining ? -1 : 1;
+    return cmp_by_order_key(p1, p2);
+}
+
+/* Helper function to compare two processes by the order they run in
+   under CFS: by virtual runtime (then in the order they became ready).
+ */
+static int cmp_vruntime(void *p1, void *p2) {
+    process_t *process1 = p1, *process2 = p2;
+    if (process1->vruntime != process2->vruntime)
+        return process1->vruntime < process2->vruntime ? -1 : 1;
+    return 0;
+}
+
+/* Helper function to make the (READY) process one of the ready processes
+   of the core (the least busy core if NULL), as the last to become ready.
+ * `node` is a node holding the process, or NULL (see `add_ready`).
+ */
+static void make_ready(process_manager_t *manager, core_t *core, 
+        process_t *process, node_t *node) {
+    process->ready_order = manager->next_ready_order++;
+    if (manager->swap_allocator && !swapped_out(process))
+        // it can now be swapped out to make room for waiting processes
+        manager->admission_pending = 1;
+    add_ready(core ? core : least_busy_core(manager), process, node);
+}
+
+/* Helper function to add the process to the ready processes of the core:
+   to its ready heap under SJF, SRTF and CFS, to the end of the queue of 
+   its priority level under MLFQ, otherwise to the end of its ready queue.
+ * `node` is a node holding the process, or NULL: it is reused in a queue
+   (made if NULL), and freed otherwise.
+ */
+static void add_ready(core_t *core, process_t *process, node_t *node) {
+    process->core = core->id;
+    if (core->fair && process->vruntime < core->min_vruntime)
+        // joins no further ahead than the processes already there
+        process->vruntime = core->min_vruntime;
+
+    queue_t *queue = core->num_levels ? core->levels[process->level] 
+            : core->ready_queue;
+    if (!core->ready_heap) {
+        enqueue(queue, node ? node : create_node(process));
+        return;
+    }
+    heap_push(core->ready_heap, process);
+    free(node);
+    node = NULL;
+}
+
+/* Helper function to return the number of ready processes of the core.
+ */
+static int count_ready(core_t *core) {
+    if (core->ready_heap)
+        return core->ready_heap->count;
+    int count = 0;
+    queue_t *queue;
+    for (int i = 0; (queue = core_queue(core, i)); i++)
+        count += queue->count;
+    return count;
+}
+
+/* Helper function to return the i-th queue of ready processes of the core
+   (from the highest priority level, under MLFQ), 
+   or NULL if it has no more (or keeps them in a heap).
+ */
+static queue_t *core_queue(core_t *core, int i) {
+    if (core->ready_heap)
+        return NULL;
+    if (core->num_levels)
+        return i < core->num_levels ? core->levels[i] : NULL;
+    return i == 0 ? core->ready_queue : NULL;
+}
+
+/* Helper function to return the core with the fewest processes ready or
+   running on it (the first on ties).
+ */
+static core_t *least_busy_core(process_manager_t *manager) {
+    core_t *least = NULL;
+    int least_load = 0;
+    for (int i = 0; i < manager->num_cores; i++) {
+        core_t *core = &manager->cores[i];
+        int load = count_ready(core) + (core->running_process ? 1 : 0);
+        if (!least || load < least_load) {
+            least = core;
+            least_load = load;
+        }
+    }
+    return least;
+}
+
+/* Helper function to let the (idle) core take the next ready process of
+   the core with the most ready processes (the first on ties), if any.
+ */
+static void steal_work(process_manager_t *manager, core_t *core) {
+    core_t *busiest = NULL;
+    for (int i = 0; i < manager->num_cores; i++) {
+        core_t *peer = &manager->cores[i];
+        if (peer != core && count_ready(peer) 
+                && (!busiest || count_ready(peer) > count_ready(busiest)))
+            busiest = peer;
+    }
+    if (!busiest) // no work to steal
+        return;
+
+    node_t *node = NULL;
+    process_t *process;
+    if (busiest->ready_heap) {
+        process = heap_pop(busiest->ready_heap);
+    } else { // the first of its highest priority
+        queue_t *queue;
+        for (int i = 0; !node && (queue = core_queue(busiest, i)); i++)
+            node = dequeue(queue);
+        process = node->data;
+    }
+    // keeping its place in the order of readiness
+    add_ready(core, process, node);
+    core->num_steals++;
+}
+
+/* Helper function to return the next of the ready processes of all cores
+   from the position, in no particular order.
+ * Returns NULL once all have been visited.
+ */
+static process_t *next_ready(process_manager_t *manager, ready_iter_t *iter) {
+    for (; iter->core < manager->num_cores; iter->core++, iter->queue = 0) {
+        core_t *core = &manager->cores[iter->core];
+        if (core->ready_heap) {
+            if (iter->index < core->ready_heap->count)
+                return core->ready_heap->entries[iter->index++].data;
+            iter->index = 0;
+            continue;
+        }
+        queue_t *queue;
+        for (; (queue = core_queue(core, iter->queue)); 
+                iter->queue++, iter->index = 0) {
+            node_t *next = iter->index ? iter->node->next : queue->head;
+            if (next) {
+                iter->node = next;
+                iter->index++;
+                return next->data;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Returns the next process to run on the core, 
    as determined by the Shortest Job First algorithm.
  * Returns NULL if no next process is found.
  */
-process_t *shortest_job_first(process_manager_t *manager) {
-    assert(manager);
+process_t *shortest_job_first(process_manager_t *manager, core_t *core) {
+    assert(manager && core);
 
-    if (manager->running_process 
-            && manager->running_process->state == RUNNING) {
+    if (core->running_process 
+            && core->running_process->state == RUNNING) {
         // there is a running process and it has not finished
-        return manager->running_process;
+        return core->running_process;
     }
 
     // no running process or that process has finished
-    node_t *shortest_job = find_shortest_job(manager->ready_queue);
-    if (!shortest_job) // no job found;
-        return NULL;
-
-    process_t *shortest_process = shortest_job->data;
-    free(shortest_job);  // unwrap
-    shortest_job = NULL;
-    
-    return shortest_process;
+    // (NULL if no job is found)
+    return heap_pop(core->ready_heap);
 }
 
-/* Returns the next process to run, 
+/* Returns the next process to run on the core, 
    as determined by the Round-Robin scheduling algorithm.
 */
-process_t *round_robin(process_manager_t *manager) {
-    assert(manager);
-    if (is_empty_queue(manager->ready_queue)) {
+process_t *round_robin(process_manager_t *manager, core_t *core) {
+    assert(manager && core);
+    if (is_empty_queue(core->ready_queue)) {
         // no other ready processes -> keep running this one
-        return manager->running_process;
+        return core->running_process;
     }
 
     // switch regardless of whether the current process has finished
-    node_t *next_job = dequeue(manager->ready_queue);
+    node_t *next_job = dequeue(core->ready_queue);
     
-    if (manager->running_process 
-            && manager->running_process->state == RUNNING) {
+    if (core->running_process 
+            && core->running_process->state == RUNNING) {
         // unfinished process put to the back of the ready queue
-        set_process_suspended(manager->running_process);
-        suspend_process(manager->running_process, manager->current_sim_time);
-        enqueue(manager->ready_queue, create_node(manager->running_process));
+        preempt(manager, core);
     }
 
     process_t *next_process = next_job->data;  // unwrap
@@ -237,70 +1124,354 @@ process_t *round_robin(process_manager_t *manager) {
     return next_process;
 }
 
-/* Checks whether the current process is completed.
+/* Returns the next process to run on the core, as determined by 
+   memory-aware Shortest Job First.
+ * Returns NULL if no next process is found.
+ */
+process_t *memory_aware_sjf(process_manager_t *manager, core_t *core) {
+    assert(manager && core);
+
+    if (core->running_process 
+            && core->running_process->state == RUNNING) {
+        // there is a running process and it has not finished
+        return core->running_process;
+    }
+
+    node_t *job = find_memory_aware_job(manager, core);
+    if (!job) // no job found
+        return NULL;
+
+    process_t *process = job->data;
+    free(job);  // unwrap
+    job = NULL;
+
+    return process;
+}
+
+/* Returns the next process to run on the core, as determined by 
+   Shortest Remaining Time First.
+ * Returns NULL if no next process is found.
+ */
+process_t *shortest_remaining_time_first(process_manager_t *manager, 
+        core_t *core) {
+    assert(manager && core);
+
+    process_t *running = core->running_process;
+    process_t *shortest = heap_peek(core->ready_heap);
+    if (running && running->state == RUNNING && (!shortest 
+            || shortest->time_remaining >= running->time_remaining)) {
+        // no ready process has strictly less time remaining
+        return running;
+    }
+
+    if (shortest && running && running->state == RUNNING)
+        preempt(manager, core);
+    return heap_pop(core->ready_heap);
+}
+
+/* Returns the next process to run on the core, as determined by the
+   Multi-Level Feedback Queue.
+ * A process runs for the time slice of its priority level, unless a 
+   process of a higher level becomes ready; if it uses up the slice, it
+   drops to the next level. All processes are raised to the highest 
+   level every boost period.
+ * Returns NULL if no next process is found.
+ */
+process_t *multilevel_feedback_queue(process_manager_t *manager, 
+        core_t *core) {
+    assert(manager && core);
+    if (manager->boost_period != NO_BOOST 
+            && manager->current_sim_time >= manager->next_boost)
+        boost_priorities(manager);
+
+    int top = highest_ready_level(core);
+    process_t *running = core->running_process;
+    if (running && running->state == RUNNING) {
+        if (core->slice_left <= 0) { // used up its time slice
+            if (running->level < core->num_levels - 1)
+                running->level++;
+            core->slice_left = manager->level_quanta[running->level];
+            if (top > running->level) // nothing else to run first
+                return running;
+        } else if (top >= running->level) {
+            return running;
+        }
+        preempt(manager, core);
+        top = highest_ready_level(core);
+    }
+    if (top == core->num_levels) // no ready processes available
+        return NULL;
+
+    node_t *next_job = dequeue(core->levels[top]);
+    process_t *next_process = next_job->data;  // unwrap
+    free(next_job);
+    next_job = NULL;
+    core->slice_left = manager->level_quanta[next_process->level];
+    return next_process;
+}
+
+/* Helper function to return the highest priority level (the smallest) 
+   with ready processes on the core, or its number of levels if none.
+ */
+static int highest_ready_level(core_t *core) {
+    int level = 0;
+    while (level < core->num_levels && is_empty_queue(core->levels[level]))
+        level++;
+    return level;
+}
+
+/* Helper function to raise all processes (ready or running, on any core)
+   to the highest priority level, keeping their order within each level.
+ */
+static void boost_priorities(process_manager_t *manager) {
+    for (int i = 0; i < manager->num_cores; i++) {
+        core_t *core = &manager->cores[i];
+        for (int l = 1; l < core->num_levels; l++) {
+            node_t *curr = core->levels[l]->head;
+            for (; curr; curr = curr->next)
+                ((process_t *) curr->data)->level = 0;
+            append_queue(core->levels[0], core->levels[l]);
+        }
+        if (core->running_process) { // with a whole time slice of the level
+            core->running_process->level = 0;
+            core->slice_left = manager->level_quanta[0];
+        }
+    }
+    manager->next_boost = manager->current_sim_time + manager->boost_period;
+}
+
+/* Returns the next process to run on the core, as determined by the
+   Completely Fair Scheduler.
+ * Each quantum, the running process's virtual runtime grows by the 
+   quantum divided by its weight, and the process with the least virtual
+   runtime runs (the running process continues on ties).
+ * Returns NULL if no next process is found.
+ */
+process_t *completely_fair(process_manager_t *manager, core_t *core) {
+    assert(manager && core);
+
+    process_t *running = core->running_process;
+    if (running && running->state == RUNNING) {
+        // it has run for another quantum
+        running->vruntime += 
+                (uint64_t) manager->quantum * VRUNTIME_SCALE / running->weight;
+        process_t *leftmost = heap_peek(core->ready_heap);
+        if (!leftmost || leftmost->vruntime >= running->vruntime) {
+            update_min_vruntime(core, running);
+            return running;
+        }
+        preempt(manager, core);
+    }
+
+    process_t *next_process = heap_pop(core->ready_heap);
+    update_min_vruntime(core, next_process);
+    return next_process;
+}
+
+/* Helper function to raise the least virtual runtime of the core to that
+   of the process to run (if any) and its ready processes, whichever is 
+   less (if it has any).
+ */
+static void update_min_vruntime(core_t *core, process_t *running) {
+    process_t *leftmost = heap_peek(core->ready_heap);
+    uint64_t least;
+    if (running && leftmost)
+        least = running->vruntime < leftmost->vruntime ? 
+                running->vruntime : leftmost->vruntime;
+    else if (running || leftmost)
+        least = running ? running->vruntime : leftmost->vruntime;
+    else
+        return;
+    if (least > core->min_vruntime)
+        core->min_vruntime = least;
+}
+
+/* Helper function to suspend the (unfinished) running process of the core,
+   making it ready again on the core.
+ */
+static void preempt(process_manager_t *manager, core_t *core) {
+    process_t *running = core->running_process;
+    set_process_suspended(running);
+    suspend_process(running, manager->current_sim_time);
+    if (page_out_of_use(manager->banks[running->bank], running)) {
+        // its pages can make room for waiting processes
+        update_bank(manager, running->bank);
+        manager->admission_pending = 1;
+    }
+    make_ready(manager, core, running, NULL);
+}
+
+/* Helper function to find and return the node for the next ready process
+   of the core under memory-aware SJF: the shortest job, except that while
+   processes wait for memory, a job whose completion would not let the 
+   smallest of them fit counts as MEMORY_AWARE_WEIGHT times as long, and 
+   ties go to the job whose completion would leave the larger hole 
+   (then as in SJF).
+ * Without waiting processes, this is the same as SJF.
+ * Returns NULL if there are no more ready processes.
+ */
+static node_t *find_memory_aware_job(process_manager_t *manager, 
+        core_t *core) {
+    queue_t *ready_queue = core->ready_queue;
+    if (is_empty_queue(ready_queue)) // no ready processes available
+        return NULL;
+
+    mem_addr_t waiting = smallest_waiting(manager);
+    node_t *best = NULL, *best_prev = NULL;
+    uint64_t best_weighted = 0;
+    mem_addr_t best_hole = 0;
+    for (node_t *curr = ready_queue->head, *prev = NULL; curr; 
+            prev = curr, curr = curr->next) {
+        process_t *process = curr->data;
+        mem_addr_t hole = 0;
+        if (waiting) {
+            // the largest hole in its bank, once it completes
+            hole = hole_if_freed(manager->banks[process->bank], process);
+            if (manager->bank_largest[process->bank] > hole)
+                hole = manager->bank_largest[process->bank];
+        }
+        uint64_t weighted = (uint64_t) process->service_time * 
+                (waiting && hole >= waiting ? 1 : MEMORY_AWARE_WEIGHT);
+
+        int better;
+        if (!best || weighted != best_weighted)
+            better = !best || weighted < best_weighted;
+        else if (hole != best_hole) // leaves the larger hole
+            better = hole > best_hole;
+        else
+            better = cmp_by_order_key(process, best->data) < 0;
+        if (better) {
+            best = curr;
+            best_prev = prev;
+            best_weighted = weighted;
+            best_hole = hole;
+        }
+    }
+
+    delete_node_from_queue(best_prev, best, ready_queue);
+    return best;
+}
+
+/* Helper function to return the smallest memory requirement of the 
+   processes waiting for memory (0 if none is).
+ */
+static mem_addr_t smallest_waiting(process_manager_t *manager) {
+    mem_addr_t smallest = 0;
+    for (node_t *curr = manager->input_queue->head; curr; curr = curr->next) {
+        process_t *process = curr->data;
+        if (!smallest || process->memory_requirement < smallest)
+            smallest = process->memory_requirement;
+    }
+    return smallest;
+}
+
+/* Checks whether the current process on each core is completed.
  */
 void check_current_process_completed(process_manager_t *manager) {
     assert(manager);
-    if (!manager->running_process) // no process currently running
+    for (int i = 0; i < manager->num_cores; i++)
+        complete_process(manager, &manager->cores[i]);
+}
+
+/* Helper function to finish the current process on the core, 
+   if it is completed.
+ */
+static void complete_process(process_manager_t *manager, core_t *core) {
+    process_t *process = core->running_process;
+    if (!process) // no process currently running
         return;
 
-    if (manager->running_process->time_remaining > 0) 
+    if (process->time_remaining > 0) 
         return;  // current process not completed
 
     /* current process completed */
     // deallocate memory
-    demalloc(manager->running_process, manager->memory);
+    demalloc(process, manager->banks[process->bank]);
+    update_bank(manager, process->bank);
+    manager->admission_pending = 1;
     // terminate the process and report
-    set_process_terminated(manager->running_process, manager->current_sim_time);
-    print_transcript(manager, manager->running_process, FINISHED);
-    terminate_process(manager->running_process, manager->current_sim_time);
-    print_transcript(manager, manager->running_process, FINISHED_PROCESS);
+    set_process_terminated(process, manager->current_sim_time);
+    print_transcript(manager, process, FINISHED);
+    terminate_process(process, manager->current_sim_time);
+    print_transcript(manager, process, FINISHED_PROCESS);
 
     /* store the info */
-    manager->total_turnaround_time += 
-            get_turnaround_time(manager->running_process);
-    double time_overhead = get_time_overhead(manager->running_process);
+    manager->total_turnaround_time += get_turnaround_time(process);
+    double time_overhead = get_time_overhead(process);
     manager->total_time_overhead += time_overhead;
     if (time_overhead > manager->max_time_overhead)
         manager->max_time_overhead = time_overhead;
     
     // remove the completed process
-    free(manager->running_process);
-    manager->running_process = NULL;
+    free(process);
+    process = NULL;
+    core->running_process = NULL;
 }
 
-/* The manager schedules the next process.
+/* The manager schedules the next process on each core.
  */
 void schedule_next_process(process_manager_t *manager) {
     assert(manager);
+    for (int i = 0; i < manager->num_cores; i++)
+        schedule_on_core(manager, &manager->cores[i]);
+}
 
-    process_t *next_process = manager->scheduler(manager);
+/* Helper function to schedule the next process on the core, 
+   letting it steal work first if it would otherwise idle.
+ * A process keeps the core while it idles for it, and for a whole quantum
+   after, so that it runs before being preempted.
+ */
+static void schedule_on_core(process_manager_t *manager, core_t *core) {
+    process_t *running = core->running_process;
+    if (running && running->state == RUNNING 
+            && (running->stall_left || core->stalled)) {
+        resume_process(running, manager->current_sim_time);
+        return;
+    }
+    if (!core->running_process && !count_ready(core))
+        steal_work(manager, core);
+
+    process_t *next_process = manager->scheduler(manager, core);
     if (!next_process) // no next job scheduled
         return;
-    if (next_process == manager->running_process) {
+    if (next_process == core->running_process) {
         // current process continues
-        resume_process(manager->running_process, manager->current_sim_time);
+        resume_process(core->running_process, manager->current_sim_time);
         return;
     }
 
     // switch process
+    if (manager->swap_allocator && swapped_out(next_process) 
+            && !swap_in(manager, next_process)) {
+        // the core idles until it fits (any process it ran was suspended)
+        add_ready(core, next_process, NULL);
+        core->running_process = NULL;
+        return;
+    }
     set_process_running(next_process);
-    manager->running_process = next_process;
-    print_transcript(manager, manager->running_process, RUNNING);
+    core->running_process = next_process;
+    // its core idles while its pages are swapped in (under virtual memory)
+    next_process->stall_left += (uint64_t) manager->swap_penalty * 
+            page_in_process(manager->banks[next_process->bank], next_process);
+    update_bank(manager, next_process->bank);
+    print_transcript(manager, next_process, RUNNING);
 
-    if (first_run(manager->running_process)) { 
+    if (first_run(next_process)) { 
         // process runs for the first time
-        create_process(manager->running_process, manager->current_sim_time);
+        create_process(next_process, manager->current_sim_time);
     } else {
-        resume_process(manager->running_process, manager->current_sim_time);
+        resume_process(next_process, manager->current_sim_time);
     }
 }
 
 /* Returns the total number of waiting processes 
-   (in the manager's input and ready queue). 
+   (in the manager's input queue and the cores' ready processes). 
  */
 int count_waiting_processes(process_manager_t *manager) {
-    return (manager->input_queue->count + manager->ready_queue->count);
+    int count = manager->input_queue->count;
+    for (int i = 0; i < manager->num_cores; i++)
+        count += count_ready(&manager->cores[i]);
+    return count;
 }
 
 /* Returns TRUE (1) if the manager finds that there are 
@@ -308,10 +1479,13 @@ int count_waiting_processes(process_manager_t *manager) {
  */
 int no_processes_left(process_manager_t *manager) {
     assert(manager);
+    for (int i = 0; i < manager->num_cores; i++) {
+        core_t *core = &manager->cores[i];
+        if (core->running_process || count_ready(core))
+            return 0;
+    }
     return is_empty_queue(manager->unsubmitted_queue)
-            && is_empty_queue(manager->input_queue)
-            && is_empty_queue(manager->ready_queue)
-            && !manager->running_process; // no currently running process
+            && is_empty_queue(manager->input_queue);
 }
 
 /* The manager prints the execution transcript, 
@@ -320,13 +1494,21 @@ int no_processes_left(process_manager_t *manager) {
 void print_transcript(process_manager_t *manager, process_t *process, 
         enum process_state type) {
     assert(manager && process);
+    // the global address, over all banks
+    mem_addr_t address = 
+            manager->bank_bases[process->bank] + process->address_assigned;
 
     printf(TRANSCRIPT, manager->current_sim_time, 
             process_state_str[type], process->name);
+    if (manager->num_cores > 1)
+        printf("core=%d,", process->core);
     switch (type) {
         case READY:
-            printf("assigned_at=%d\n", 
-                    ((mem_entry_t *) process->address_assigned->data)->start);
+        case SWAPPED_IN:
+            printf("assigned_at=%" PRI_ADDR "\n", address);
+            break;
+        case SWAPPED_OUT:
+            printf("freed_at=%" PRI_ADDR "\n", address);
             break;
         case RUNNING:
             printf("remaining_time=%u\n", process->time_remaining);
@@ -335,7 +1517,7 @@ void print_transcript(process_manager_t *manager, process_t *process,
             printf("proc_remaining=%d\n", count_waiting_processes(manager));
             break;
         case FINISHED_PROCESS:
-            printf("sha=%s\n", manager->running_process->hash);
+            printf("sha=%s\n", process->hash);
             break;
         default:
             printf("Unknown transcript type\n");
@@ -371,6 +1553,84 @@ void print_performance_stats(process_manager_t *manager) {
         round_to_two_dp(manager->max_time_overhead), 
         round_to_two_dp(manager->total_time_overhead / manager->num_process));
     printf("Makespan %u\n", manager->current_sim_time);
+
+    /* totals over all banks */
+    int num_compactions = 0;
+    mem_addr_t compaction_moved = 0, max_waste = 0;
+    mem_addr_t total_requested = 0, total_allocated = 0;
+    long page_faults = 0, evictions = 0;
+    for (int i = 0; i < manager->num_banks; i++) {
+        memory_t *bank = manager->banks[i];
+        num_compactions += bank->num_compactions;
+        compaction_moved += bank->compaction_moved;
+        max_waste += bank->max_waste; // (an upper bound on the peak)
+        total_requested += bank->total_requested;
+        total_allocated += bank->total_allocated;
+        if (bank->allocator == VIRTUAL_ALLOCATOR) {
+            page_faults += bank->paging->page_faults;
+            evictions += bank->paging->evictions;
+        }
+    }
+
+    memory_t *memory = manager->banks[0]; // all banks are set up alike
+    if (memory->compaction_threshold != NO_COMPACTION) {
+        // number of compactions, and total size of the entries moved
+        printf("Compaction %d %" PRI_ADDR "\n", num_compactions, 
+                compaction_moved);
+    }
+    if (memory->allocator == VIRTUAL_ALLOCATOR) {
+        // pages swapped in and out
+        printf("Paging %ld %ld\n", page_faults, evictions);
+    }
+    if (manager->swap_allocator) {
+        // processes swapped out and in, and their total size
+        printf("Swapping %d %d %" PRI_ADDR "\n", manager->num_swap_outs, 
+                manager->num_swap_ins, manager->swap_traffic);
+    }
+    if (memory->allocator != SEGMENT_ALLOCATOR && total_allocated) {
+        // peak memory wasted inside blocks/pages, and the share of all
+        // allocated space that was wasted
+        printf("Internal fragmentation %" PRI_ADDR " %.2lf\n", 
+                max_waste, round_to_two_dp(1 - 
+                (double) total_requested / total_allocated));
+    }
+    if (memory->slab) {
+        for (int i = 0; i < manager->num_banks; i++) {
+            slab_allocator_t *slab = manager->banks[i]->slab;
+            for (int c = 0; c < slab->num_classes; c++) {
+                // allocations from the slabs of the size, peak slots in 
+                // use and reserved, and peak memory in free slots
+                slab_class_t *class = &slab->classes[c];
+                printf("Slab %" PRI_ADDR " %ld %" PRId64 " %" PRId64 
+                        " %" PRI_ADDR "\n", class->size, class->num_allocs, 
+                        class->max_slots_used, class->max_slots, 
+                        class->max_waste);
+            }
+        }
+    }
+    if (manager->num_banks > 1) {
+        for (int i = 0; i < manager->num_banks; i++) {
+            // allocations made in the bank, and its peak memory in use
+            memory_t *bank = manager->banks[i];
+            printf("Bank %d %ld %" PRI_ADDR "\n", i, 
+                    bank->num_attempts - bank->num_failures, 
+                    bank->capacity - bank->min_free);
+        }
+    }
+    if (manager->num_cores > 1) {
+        for (int i = 0; i < manager->num_cores; i++) {
+            // time spent running processes, as a share of the makespan, 
+            // and processes taken from other cores
+            core_t *core = &manager->cores[i];
+            printf("Core %d %u %.2lf %d\n", i, core->busy_time, 
+                    round_to_two_dp(manager->current_sim_time ? 
+                    (double) core->busy_time / manager->current_sim_time 
+                    : 0), core->num_steals);
+        }
+    }
+    if (manager->memory_stats)
+        print_memory_stats(manager->memory_stats, manager->banks, 
+                manager->num_banks);
 }
 
 /* The manager runs a cycle. 
@@ -383,6 +1643,9 @@ int run_cycle(process_manager_t *manager) {
     submit_processes(manager);
     /* allocate memory to processes in input queue */
     manager->malloc_strategy(manager);
+    if (manager->memory_stats)
+        sample_memory(manager->memory_stats, manager->banks, 
+                manager->num_banks, manager->current_sim_time);
     /* determine next process to run */
     schedule_next_process(manager);
 
@@ -390,14 +1653,67 @@ int run_cycle(process_manager_t *manager) {
         return 0;
     
     manager->current_sim_time += manager->quantum;
-    if (manager->running_process)
-        manager->running_process->time_remaining = 
-                uint_safe_subtract(manager->running_process->time_remaining, 
-                        manager->quantum); // to prevent overflow
+    for (int i = 0; i < manager->num_cores; i++) {
+        core_t *core = &manager->cores[i];
+        process_t *running = core->running_process;
+        core->stalled = 0;
+        if (!running)
+            continue;
+        // it runs for what is left of the quantum after its core idles
+        uint32_t stalled = running->stall_left < manager->quantum ? 
+                running->stall_left : manager->quantum;
+        running->stall_left -= stalled;
+        core->stalled = stalled > 0;
+        if (core->num_levels && stalled < manager->quantum)
+            core->slice_left--; // it has run for another quantum (under MLFQ)
+        running->time_remaining = uint_safe_subtract(running->time_remaining,
+                manager->quantum - stalled); // to prevent overflow
+        core->busy_time += manager->quantum - stalled;
+    }
+    skip_idle_cycles(manager);
 
     return 1;
 }
 
+/* Helper function to move the clock, when no process is running, ready 
+   or waiting for memory, straight to the first cycle at or after the 
+   next arrival, keeping to the quantum grid (and to the priority boosts
+   the idle cycles skipped would have made), so the transcript is as if 
+   those cycles had run.
+ * Skips nothing while the memory is sampled, as each cycle is recorded.
+ */
+static void skip_idle_cycles(process_manager_t *manager) {
+    node_t *next = manager->unsubmitted_queue->head;
+    if (!next || manager->memory_stats 
+            || !is_empty_queue(manager->input_queue))
+        return;
+    for (int i = 0; i < manager->num_cores; i++) {
+        core_t *core = &manager->cores[i];
+        if (core->running_process || count_ready(core))
+            return;
+    }
+
+    uint64_t now = manager->current_sim_time, quantum = manager->quantum;
+    uint64_t arrival = ((process_t *) next->data)->time_arrived;
+    if (arrival <= now) // arrives in this cycle
+        return;
+    uint64_t resume = now + (arrival - now + quantum - 1) / quantum * quantum;
+
+    if (manager->boost_period != NO_BOOST && manager->next_boost < resume) {
+        // boosts (raising no process) are made in the first cycle due,
+        // and then every period rounded up to the grid
+        uint64_t due = manager->next_boost > now ? manager->next_boost : now;
+        uint64_t boost = now + (due - now + quantum - 1) / quantum * quantum;
+        if (boost < resume) {
+            uint64_t period = (manager->boost_period + quantum - 1) 
+                    / quantum * quantum;
+            boost += (resume - quantum - boost) / period * period;
+            manager->next_boost = boost + manager->boost_period;
+        }
+    }
+    manager->current_sim_time = resume;
+}
+
 /* Wrapper function to run the process manager.
  */
 void run(process_manager_t *manager) {
@@ -416,8 +1732,27 @@ void clean_up(process_manager_t *manager) {
     manager->unsubmitted_queue = NULL;
     free(manager->input_queue);
     manager->input_queue = NULL;
-    free(manager->ready_queue);
-    manager->ready_queue = NULL;
-    free_memory(manager->memory);
-    manager->memory = NULL;
+    for (int i = 0; i < manager->num_cores; i++) {
+        free(manager->cores[i].ready_queue);
+        if (manager->cores[i].ready_heap)
+            free_heap(manager->cores[i].ready_heap);
+        for (int l = 0; l < manager->cores[i].num_levels; l++)
+            free(manager->cores[i].levels[l]);
+    }
+    free(manager->cores);
+    manager->cores = NULL;
+    for (int i = 0; i < manager->num_banks; i++)
+        free_memory(manager->banks[i]);
+    free(manager->banks);
+    manager->banks = NULL;
+    free(manager->bank_bases);
+    manager->bank_bases = NULL;
+    free(manager->bank_largest);
+    manager->bank_largest = NULL;
+    free(manager->pack_last);
+    manager->pack_last = NULL;
+    if (manager->memory_stats) {
+        free_memory_stats(manager->memory_stats);
+        manager->memory_stats = NULL;
+    }
 }
\ No newline at end of file
@@ -13,47 +13,160 @@
 #include <stdio.h>
 #include <unistd.h>
 #include "queue.h"
+#include "heap.h"
 #include "memory.h"
+#include "memory_stats.h"
 #include "process_data.h"
 #include "communicator.h"
 
 #define TRANSCRIPT "%u,%s,process_name=%s," // general transcript format
 
 typedef struct process_manager process_manager_t;
+typedef struct core core_t;
 /* function pointer types for scheduling and memory strategies */
-typedef process_t *(*scheduler_fp_t) (process_manager_t *);
+typedef process_t *(*scheduler_fp_t) (process_manager_t *, core_t *);
 typedef void (*memory_strategy_fp_t) (process_manager_t *);
 
-enum scheduler {SJF, RR};                   // scheduling agorithms
-enum memory_strategy {INFINITE, BEST_FIT};  // memory strategies
+enum scheduler {SJF, RR, MSJF, SRTF, MLFQ,  // scheduling agorithms
+        CFS};
+enum memory_strategy {INFINITE, BEST_FIT, BUDDY,   // memory strategies
+        FIRST_FIT, NEXT_FIT, WORST_FIT, BITMAP, VIRTUAL, TLSF, SLAB};
+
+#define DEFAULT_SWAP_PENALTY 1  // time to swap in a page of virtual memory
+#define NO_SWAPPING -1          // swap latency: never swap processes out
+
+#define MAX_CORES 64            // most CPU cores a manager can have
+#define MAX_LEVELS 16           // most priority levels under MLFQ
+#define DEFAULT_NUM_LEVELS 3    // levels, each with twice the time slice of 
+                                // the one above, unless given
+#define DEFAULT_BOOST_PERIOD 100 // time between priority boosts under MLFQ
+#define NO_BOOST 0              // boost period: never boost priorities
+#define VRUNTIME_SCALE 1024     // virtual runtime of a quantum at weight 1
+#define MAX_BANKS 64            // most memory banks a manager can have
+#define NO_BANK -1              // no memory bank fits a process
+
+/* how a memory bank is chosen for a process */
+enum placement {LOCAL_FIRST, LEAST_LOADED, BEST_FIT_BANK};
+
+/* the order waiting processes are tried in, for admission into memory */
+enum admission {ARRIVAL_ORDER, LARGEST_FIRST, BEST_PACK};
+
+#define MAX_PACKED_HOLE 65536   // largest hole (in MB) best-pack searches
+#define MAX_PACKED_PROCESSES 64 // earliest waiting processes best-pack 
+                                // searches combinations of
+
+// how many times longer memory-aware SJF counts a job whose completion
+// would not let a waiting process fit
+#define MEMORY_AWARE_WEIGHT 2
+
+/* options for building a process manager */
+typedef struct {
+    char *scheduler;        // name of the scheduling algorithm
+    char *memory_strategy;  // name of the memory strategy
+    int quantum;
+    char *memory_map;       // name of the memory map representation
+    mem_addr_t memory_capacity; // in MB
+    double compaction_threshold; // or NO_COMPACTION
+    char *stats_file;       // where to write the memory time series, or NULL
+    uint32_t swap_penalty;  // time to swap in a page of virtual memory
+    // time to swap a process out to disk, and back in, or NO_SWAPPING
+    int64_t swap_out_latency;
+    int64_t swap_in_latency;
+    // capacities of the memory banks (in MB), or a single bank of 
+    // `memory_capacity` if there are none
+    mem_addr_t bank_capacities[MAX_BANKS];
+    int num_banks;
+    char *placement;        // name of the placement policy
+    char *admission;        // name of the admission policy
+    int num_cores;
+    // time slices of the MLFQ priority levels (in quanta), or the default
+    // levels if there are none
+    int level_quanta[MAX_LEVELS];
+    int num_levels;
+    uint32_t boost_period;  // or NO_BOOST
+} manager_config_t;
+
+/* a CPU core, running processes from its own ready processes */
+struct core {
+    int id;
+    process_t *running_process;
+    queue_t *ready_queue;
+    // the ready processes under SJF and SRTF, in place of the ready queue 
+    // (NULL under other schedulers)
+    heap_t *ready_heap;
+    // the ready processes under MLFQ, a queue per priority level, in place
+    // of the ready queue (none under other schedulers)
+    queue_t *levels[MAX_LEVELS];
+    int num_levels;
+    int slice_left;         // quanta left in the running process's time 
+                            // slice (under MLFQ)
+    int fair;               // whether it shares time by virtual runtime
+    uint64_t min_vruntime;  // (never decreasing) least virtual runtime of
+                            // its processes (under CFS)
+    int stalled;            // whether it idled for its running process in
+                            // the last cycle (which then runs on)
+
+    // for performance statistics
+    uint32_t busy_time;     // time spent running processes
+    int num_steals;         // processes taken from the ready processes of 
+                            // other cores
+};
 
 struct process_manager {
     int quantum;
+    uint32_t swap_penalty;
     uint32_t current_sim_time;  // current simulation time
 
     queue_t *unsubmitted_queue; // automatically sorted by time arrived
     queue_t *input_queue;
-    queue_t *ready_queue;
-    process_t *running_process;
+    core_t *cores;
+    int num_cores;
+    uint64_t next_ready_order;  // of the next process to become ready
+
+    /* under MLFQ */
+    int level_quanta[MAX_LEVELS]; // time slice of each level, in quanta
+    int num_levels;
+    uint32_t boost_period;      // or NO_BOOST
+    uint32_t next_boost;        // when priorities are next boosted
+
+    /* memory banks, each with its own allocator */
+    memory_t **banks;
+    int num_banks;
+    mem_addr_t *bank_bases;     // global address of the start of each bank
+    mem_addr_t *bank_largest;   // largest allocatable block in each bank
+    enum placement placement;
+    int next_home;              // home bank of the next arriving process
 
-    memory_t *memory;
     scheduler_fp_t scheduler;
     memory_strategy_fp_t malloc_strategy;
+    enum admission admission;
+    // whether memory was freed or processes arrived since the last admission
+    int admission_pending;
+    int *pack_last;             // search buffer under best-pack (else NULL)
+
+    /* swapping READY processes out to disk */
+    process_allocator_fp_t swap_allocator; // NULL unless swapping
+    uint32_t swap_out_latency;
+    uint32_t swap_in_latency;
+    int num_swap_outs;
+    int num_swap_ins;
+    mem_addr_t swap_traffic;    // total size of the processes swapped
 
     // for performance statistics
     uint64_t total_turnaround_time;
     uint32_t num_process;
     double total_time_overhead;
     double max_time_overhead;
+    memory_stats_t *memory_stats; // NULL unless sampling memory
 };
 
 
 /************** function declarations **************/
 
-/* Creates, initializes, and returns a process manager.
+/* Creates, initializes, and returns a process manager,
+   configured by the given options.
  */
-process_manager_t *create_manager(FILE *f, char *scheduler, 
-        char *memory_strategy, int quantum);
+process_manager_t *create_manager(FILE *f, manager_config_t *config);
 
 /* Submits processes (moves processes from the unsubmitted 
    queue to the input queue in the manager).
@@ -68,27 +181,88 @@ void infinite_malloc(process_manager_t *manager);
  */
 void best_fit_malloc(process_manager_t *manager);
 
-/* Returns the next process to run, 
+/* Manager allocates memory by the buddy system to submitted processes.
+ */
+void buddy_malloc(process_manager_t *manager);
+
+/* Manager allocates memory by first fit to submitted processes.
+ */
+void first_fit_malloc(process_manager_t *manager);
+
+/* Manager allocates memory by next fit to submitted processes.
+ */
+void next_fit_malloc(process_manager_t *manager);
+
+/* Manager allocates memory by worst fit to submitted processes.
+ */
+void worst_fit_malloc(process_manager_t *manager);
+
+/* Manager allocates memory as runs of pages to submitted processes.
+ */
+void bitmap_malloc(process_manager_t *manager);
+
+/* Manager allocates memory by two-level segregated fit 
+   to submitted processes.
+ */
+void tlsf_malloc(process_manager_t *manager);
+
+/* Manager allocates memory from slabs for recurring sizes 
+   to submitted processes.
+ */
+void slab_malloc(process_manager_t *manager);
+
+/* Manager allocates virtual memory (pages, not all in memory) 
+   to submitted processes.
+ */
+void virtual_malloc(process_manager_t *manager);
+
+/* Returns the next process to run on the core, 
    as determined by the Shortest Job First algorithm.
  * Returns NULL if no next process is found.
  */
-process_t *shortest_job_first(process_manager_t *manager);
+process_t *shortest_job_first(process_manager_t *manager, core_t *core);
 
-/* Returns the next process to run, 
+/* Returns the next process to run on the core, 
    as determined by the Round-Robin scheduling algorithm.
 */
-process_t *round_robin(process_manager_t *manager);
+process_t *round_robin(process_manager_t *manager, core_t *core);
+
+/* Returns the next process to run on the core, as determined by 
+   memory-aware Shortest Job First.
+ * Returns NULL if no next process is found.
+ */
+process_t *memory_aware_sjf(process_manager_t *manager, core_t *core);
+
+/* Returns the next process to run on the core, as determined by 
+   Shortest Remaining Time First.
+ * Returns NULL if no next process is found.
+ */
+process_t *shortest_remaining_time_first(process_manager_t *manager, 
+        core_t *core);
+
+/* Returns the next process to run on the core, as determined by the
+   Multi-Level Feedback Queue.
+ * Returns NULL if no next process is found.
+ */
+process_t *multilevel_feedback_queue(process_manager_t *manager, 
+        core_t *core);
+
+/* Returns the next process to run on the core, as determined by the
+   Completely Fair Scheduler.
+ * Returns NULL if no next process is found.
+ */
+process_t *completely_fair(process_manager_t *manager, core_t *core);
 
-/* Checks whether the current process is completed.
+/* Checks whether the current process on each core is completed.
  */
 void check_current_process_completed(process_manager_t *manager);
 
-/* The manager schedules the next process.
+/* The manager schedules the next process on each core.
  */
 void schedule_next_process(process_manager_t *manager);
 
 /* Returns the total number of waiting processes 
-   (in the manager's input and ready queue). 
+   (in the manager's input queue and the cores' ready processes). 
  */
 int count_waiting_processes(process_manager_t *manager);
 
@@ -1,165 +1,820 @@
 /*-----------------------------------------------------------------------------
- * Project 1 
+ * Project 1
  * Created by Angel He (angelh1@student.unimelb.edu.au) 25/03/2023
  * memory.c :
-              = the implementation of the module `memory` of the project 
+              = the implementation of the module `memory` of the project
  ----------------------------------------------------------------------------*/
 
 #include <stdlib.h>
 #include <assert.h>
 #include "memory.h"
 
-/* Creates a memory entry with the given type, starting address and length.
+/* some 'private' helper functions */
+static avl_key_t hole_key(mem_entry_t *entry);
+static void index_hole(mem_entry_t *entry, memory_t *memory);
+static void unindex_hole(mem_entry_t *entry, memory_t *memory);
+static mem_addr_t allocated_size(memory_t *memory, mem_addr_t requirement);
+static void record_allocation(memory_t *memory, process_t *process);
+static void record_free(memory_t *memory);
+static void record_attempt(memory_t *memory, process_t *process, 
+        long scanned);
+static int reserve_slab(memory_t *memory, int size_class);
+static int free_slab_slot(memory_t *memory, process_t *process);
+
+
+/* Creates, initializes, and returns the memory structure of the given 
+   capacity (in MB), managed by the given allocator.
+ * Segments are stored in a map of the given type.
  */
-mem_entry_t *create_mem_entry(int type, int start, int length) {
-    mem_entry_t *entry = malloc(sizeof(*entry));
-    assert(entry);
-    
-    entry->type = type;
-    entry->start = start;
-    entry->length = length;
-    
-    return entry;
+memory_t *initialize_memory(enum memory_allocator allocator, 
+        enum map_type map_type, mem_addr_t capacity) {
+    assert(capacity > 0);
+    memory_t *memory = malloc(sizeof(*memory));
+    assert(memory);
+    memory->capacity = capacity;
+    memory->allocator = allocator;
+    memory->map = NULL;
+    memory->holes = NULL;
+    memory->buddy = NULL;
+    memory->bitmap = NULL;
+    memory->paging = NULL;
+    memory->tlsf = NULL;
+    memory->hole_array = NULL;
+    memory->slab = NULL;
+    memory->rover = 0;
+    memory->compaction_threshold = NO_COMPACTION;
+    memory->free = memory->min_free = capacity;
+    memory->num_compactions = 0;
+    memory->num_attempts = memory->num_failures = 0;
+    memory->segments_scanned = memory->max_scanned = 0;
+    memory->compaction_moved = 0;
+    memory->waste = memory->max_waste = 0;
+    memory->total_requested = memory->total_allocated = 0;
+
+    switch (allocator) {
+        case SEGMENT_ALLOCATOR: {
+            // memory initialized as a single hole spanning the whole capacity
+            mem_entry_t entry = {HOLE, 0, capacity, NULL};
+            memory->map = make_memory_map(map_type, &entry, 1);
+            memory->holes = make_empty_avl();
+            index_hole(&entry, memory);
+            break;
+        }
+        case BUDDY_ALLOCATOR:
+            memory->buddy = create_buddy(capacity);
+            break;
+        case BITMAP_ALLOCATOR:
+            memory->bitmap = create_bitmap(capacity);
+            memory->free = memory->bitmap->num_pages * PAGE_SIZE;
+            break;
+        case VIRTUAL_ALLOCATOR:
+            memory->paging = create_paging(capacity);
+            memory->free = memory->paging->num_frames * PAGE_SIZE;
+            break;
+    }
+    return memory;
 }
 
-/* Creates, initializes, and returns the memory structure.
+/* Helper function to return the key of a hole in the size index.
  */
-memory_t *initialize_memory() {
-    // memory initialized as a single hole of size MEMORY_CAPACITY (2048) MB
-    mem_entry_t *entry = create_mem_entry(HOLE, 0, MEMORY_CAPACITY);
-    memory_t *memory = make_empty_dll();
-    memory = insert_at_dll_foot(memory, create_double_node(entry));
-    return memory;
+static avl_key_t hole_key(mem_entry_t *entry) {
+    return make_avl_key(entry->length, entry->start);
+}
+
+/* Helper function to add the hole to the size index.
+ */
+static void index_hole(mem_entry_t *entry, memory_t *memory) {
+    assert(entry->type == HOLE);
+    avl_insert(memory->holes, hole_key(entry), NULL);
+    if (memory->tlsf)
+        tlsf_insert(memory->tlsf, entry->start, entry->length);
+    if (memory->hole_array)
+        hole_array_insert(memory->hole_array, entry->start, entry->length);
+}
+
+/* Helper function to remove the hole from the size index.
+ * Must be called before the entry's length or start changes.
+ */
+static void unindex_hole(mem_entry_t *entry, memory_t *memory) {
+    assert(avl_find(memory->holes, hole_key(entry)));
+    avl_delete(memory->holes, hole_key(entry));
+    if (memory->tlsf)
+        tlsf_remove(memory->tlsf, entry->start, entry->length);
+    if (memory->hole_array)
+        hole_array_remove(memory->hole_array, entry->start);
 }
 
-/* Allocates memory to the process by best fit.
+/* Allocates memory to the process by best fit
+   (the smallest hole that fits, with the lowest address on ties).
  */
 void malloc_by_best_fit(memory_t *memory, process_t *process) {
     assert(memory && process);
-    double_node_t *curr = memory->head;
-    assert(curr);
-    mem_entry_t *curr_entry;
-
-    int smallest_hole_size = MEMORY_CAPACITY+1;
-    double_node_t *best_hole = NULL;
-    
-    while (curr) {
-        curr_entry = curr->data;
-        if (curr_entry->type == HOLE 
-                && curr_entry->length >= process->memory_requirement
-                && curr_entry->length < smallest_hole_size) {
-            // this hole can fit the program and is a better (smaller) fit
-            smallest_hole_size = curr_entry->length;
-            best_hole = curr;
-        }
-        curr = curr->next;
+    long visits = memory->holes->visits;
+
+    // smallest (length, start) with length >= requirement; starts are >= 0
+    avl_node_t *best = avl_lower_bound(memory->holes,
+            make_avl_key(process->memory_requirement, -1));
+
+    if (best) // only allocate memory to the process if there is a fit
+        allocate_process(best->key.secondary, process, memory);
+    record_attempt(memory, process, memory->holes->visits - visits);
+}
+
+/* Allocates memory to the process by first fit
+   (the lowest-addressed hole that fits).
+ * The hole array must be enabled.
+ */
+void malloc_by_first_fit(memory_t *memory, process_t *process) {
+    assert(memory && memory->hole_array && process);
+    hole_array_t *holes = memory->hole_array;
+    int64_t found = holes->find_fit(holes->lengths, 0, holes->count, 
+            process->memory_requirement);
+
+    if (found >= 0)
+        allocate_process(holes->starts[found], process, memory);
+    record_attempt(memory, process, found >= 0 ? found + 1 : holes->count);
+}
+
+/* Allocates memory to the process by next fit
+   (the first hole that fits, searching on from the previous allocation).
+ * The hole array must be enabled.
+ */
+void malloc_by_next_fit(memory_t *memory, process_t *process) {
+    assert(memory && memory->hole_array && process);
+    hole_array_t *holes = memory->hole_array;
+    mem_addr_t requirement = process->memory_requirement;
+
+    // search from the rover to the end of memory, then wrap around
+    int64_t rover = hole_array_lower_bound(holes, memory->rover);
+    int64_t found = holes->find_fit(holes->lengths, rover, holes->count, 
+            requirement);
+    long scanned = found >= 0 ? found - rover + 1 : holes->count - rover;
+    if (found < 0) {
+        found = holes->find_fit(holes->lengths, 0, rover, requirement);
+        scanned += found >= 0 ? found + 1 : rover;
     }
 
-    //printf("best hole: %d\n", ((mem_entry_t *)(best_hole->data))->start);
-    if (best_hole) // only allocate memory to the process if there is a fit
-        allocate_process(best_hole, process, memory);
+    if (found >= 0) {
+        mem_addr_t start = holes->starts[found];
+        allocate_process(start, process, memory);
+        // resume from the entry following this allocation
+        memory->rover = start + requirement;
+    }
+    record_attempt(memory, process, scanned);
 }
 
-/* Allocates the node (in the given memory list) to the process.
+/* Allocates memory to the process by worst fit
+   (the largest hole, with the lowest address on ties).
  */
-void allocate_process(double_node_t *node, process_t *process, 
-        memory_t *memory) {
-    assert(node && process);
+void malloc_by_worst_fit(memory_t *memory, process_t *process) {
+    assert(memory && process);
+    long visits = memory->holes->visits;
+
+    // the size index gives the largest hole; then its lowest address
+    avl_node_t *largest = avl_max(memory->holes);
+    if (largest && largest->key.primary >= process->memory_requirement) {
+        avl_node_t *worst = avl_lower_bound(memory->holes, 
+                make_avl_key(largest->key.primary, -1));
+        allocate_process(worst->key.secondary, process, memory);
+    }
+    record_attempt(memory, process, memory->holes->visits - visits);
+}
+
+/* Allocates memory to the process by two-level segregated fit
+   (a hole of the smallest size class that is sure to fit).
+ * TLSF must be enabled.
+ */
+void malloc_by_tlsf(memory_t *memory, process_t *process) {
+    assert(memory && memory->tlsf && process);
+    mem_addr_t start = tlsf_find(memory->tlsf, process->memory_requirement);
+    if (start != NOT_ASSIGNED)
+        allocate_process(start, process, memory);
+    record_attempt(memory, process, 0);
+}
+
+/* Allocates memory to the process from a slab for its size, reserving a
+   new slab (by best fit) if none has a free slot; sizes without slabs 
+   are allocated by best fit.
+ * Slabs must be enabled.
+ */
+void malloc_by_slab(memory_t *memory, process_t *process) {
+    assert(memory && memory->slab && process);
+    mem_addr_t size = process->memory_requirement;
+    int size_class = slab_class(memory->slab, size);
+    if (size_class == NO_SLAB_CLASS) { // an unusual size (so far)
+        malloc_by_best_fit(memory, process);
+        if (process->address_assigned != NOT_ASSIGNED)
+            slab_count_size(memory->slab, size);
+        return;
+    }
+
+    long visits = memory->holes->visits;
+    process->address_assigned = slab_alloc(memory->slab, size_class);
+    if (process->address_assigned == NOT_ASSIGNED 
+            && reserve_slab(memory, size_class))
+        process->address_assigned = slab_alloc(memory->slab, size_class);
+    if (process->address_assigned != NOT_ASSIGNED) {
+        // the slot was counted as wasted, and free memory, with its slab
+        memory->waste -= size;
+        memory->total_requested += size;
+        memory->total_allocated += size;
+    }
+    record_attempt(memory, process, memory->holes->visits - visits);
+}
+
+/* Helper function to reserve a slab for the class, of as many slots
+   (up to SLAB_SLOTS) as the best fitting hole holds.
+ * Returns TRUE (1) if a slab was reserved, FALSE (0) if no hole holds
+   even one slot.
+ */
+static int reserve_slab(memory_t *memory, int size_class) {
+    mem_addr_t size = memory->slab->classes[size_class].size;
+    for (int slots = SLAB_SLOTS; slots > 0; slots /= 2) {
+        mem_addr_t length = slots * size;
+        avl_node_t *best = avl_lower_bound(memory->holes, 
+                make_avl_key(length, -1));
+        if (!best)
+            continue;
 
-    ((mem_entry_t *) node->data)->type = PROCESS;
-    process->address_assigned = node;
+        mem_addr_t start = best->key.secondary;
+        mem_entry_t *entry = 
+                map_entry(memory->map, map_find(memory->map, start));
+        unindex_hole(entry, memory); // no longer a hole
+        entry->type = SLAB_REGION;
+        split_mem_entry(start, length, memory);
+        slab_add(memory->slab, size_class, start, slots);
+
+        // the slots are wasted until allocated
+        memory->free -= length;
+        record_free(memory);
+        memory->waste += length;
+        if (memory->waste > memory->max_waste)
+            memory->max_waste = memory->waste;
+        return 1;
+    }
+    return 0;
+}
+
+/* Helper function to return the process's slot to its slab (and the 
+   slab's region to memory, if it is left empty), if it is in a slab.
+ * Returns TRUE (1) if it was in a slab, FALSE (0) otherwise.
+ */
+static int free_slab_slot(memory_t *memory, process_t *process) {
+    mem_addr_t start, length;
+    if (!slab_free(memory->slab, process->address_assigned, &start, 
+            &length))
+        return 0;
+
+    memory->waste += process->memory_requirement;
+    if (start != NOT_ASSIGNED) { // the slab is empty
+        merge_adjacent_holes(start, memory);
+        memory->waste -= length;
+        memory->free += length;
+    }
+    return 1;
+}
+
+/* Allocates memory to the process by the buddy system.
+ */
+void malloc_by_buddy(memory_t *memory, process_t *process) {
+    assert(memory && memory->buddy && process);
+    process->address_assigned = 
+            buddy_alloc(memory->buddy, process->memory_requirement);
+    record_allocation(memory, process);
+    record_attempt(memory, process, 0);
+}
+
+/* Allocates memory to the process as a run of pages in the bitmap.
+ */
+void malloc_by_bitmap(memory_t *memory, process_t *process) {
+    assert(memory && memory->bitmap && process);
+    process->address_assigned = 
+            bitmap_alloc(memory->bitmap, process->memory_requirement);
+    record_allocation(memory, process);
+    record_attempt(memory, process, 0);
+}
+
+/* Allocates memory to the process as pages of virtual memory,
+   not all of which need to be in frames.
+ */
+void malloc_by_virtual(memory_t *memory, process_t *process) {
+    assert(memory && memory->paging && process);
+    process->address_assigned = paging_alloc(memory->paging, process);
+    memory->free = memory->paging->free_frames * PAGE_SIZE;
+    record_free(memory);
+    record_attempt(memory, process, 0);
+}
+
+/* Swaps in the pages of the process (about to run) under virtual memory,
+   keeping them in memory until it is out of use (or finished).
+ * Returns the number of pages swapped in (0 under other allocators).
+ */
+int64_t page_in_process(memory_t *memory, process_t *process) {
+    assert(memory && process);
+    if (memory->allocator != VIRTUAL_ALLOCATOR 
+            || process->address_assigned == NOT_ASSIGNED)
+        return 0;
+    int64_t faults = page_in(memory->paging, process);
+    memory->free = memory->paging->free_frames * PAGE_SIZE;
+    record_free(memory);
+    return faults;
+}
+
+/* Lets the pages of the process (no longer running, but not finished) 
+   be evicted again under virtual memory.
+ * Returns TRUE (1) if it holds pages that are now evictable, 
+   FALSE (0) otherwise.
+ */
+int page_out_of_use(memory_t *memory, process_t *process) {
+    assert(memory && process);
+    if (memory->allocator != VIRTUAL_ALLOCATOR 
+            || process->address_assigned == NOT_ASSIGNED)
+        return 0;
+    paging_unpin(memory->paging, process);
+    return process->pages_resident > 0;
+}
+
+/* Helper function to return the size of memory actually allocated 
+   to a process with the given requirement.
+ */
+static mem_addr_t allocated_size(memory_t *memory, mem_addr_t requirement) {
+    switch (memory->allocator) {
+        case BUDDY_ALLOCATOR:
+            return (mem_addr_t) 1 << buddy_order(requirement);
+        case BITMAP_ALLOCATOR:
+            return pages_needed(requirement) * PAGE_SIZE;
+        default: // segments are cut to the exact requirement
+            return requirement;
+    }
+}
+
+/* Helper function to account for the internal fragmentation of 
+   the process's allocation, if it succeeded.
+ */
+static void record_allocation(memory_t *memory, process_t *process) {
+    if (process->address_assigned == NOT_ASSIGNED)
+        return;
+    mem_addr_t size = allocated_size(memory, process->memory_requirement);
+    memory->waste += size - process->memory_requirement;
+    if (memory->waste > memory->max_waste)
+        memory->max_waste = memory->waste;
+    memory->total_requested += process->memory_requirement;
+    memory->total_allocated += size;
+    memory->free -= size;
+    record_free(memory);
+}
+
+/* Helper function to keep track of the least free memory, 
+   after the free memory drops.
+ */
+static void record_free(memory_t *memory) {
+    if (memory->free < memory->min_free)
+        memory->min_free = memory->free;
+}
+
+/* Helper function to count an allocation attempt for the process, 
+   which examined `scanned` memory entries (or index nodes).
+ */
+static void record_attempt(memory_t *memory, process_t *process, 
+        long scanned) {
+    memory->num_attempts++;
+    if (process->address_assigned == NOT_ASSIGNED)
+        memory->num_failures++;
+    memory->segments_scanned += scanned;
+    if (scanned > memory->max_scanned)
+        memory->max_scanned = scanned;
+}
+
+/* Allocates the hole starting at the address to the process.
+ */
+void allocate_process(mem_addr_t start, process_t *process, memory_t *memory) {
+    assert(process && memory);
+    mem_entry_t *entry = map_entry(memory->map, map_find(memory->map, start));
+    assert(entry && entry->type == HOLE);
+
+    unindex_hole(entry, memory); // no longer a hole
+    entry->type = PROCESS;
+    entry->owner = process;
+    process->address_assigned = start;
+    record_allocation(memory, process);
 
     // split out the portion unused by the process
-    split_mem_entry(node, process->memory_requirement, memory);
+    split_mem_entry(start, process->memory_requirement, memory);
 }
 
-/* Splits the memory entry held in the node into two:
-   - a process type of the given size, and 
+/* Splits the memory entry starting at the address into two:
+   - a process type of the given size, and
    - a hole type (if necessary), following the process entry.
  */
-void split_mem_entry(double_node_t *node, int process_size, memory_t *memory) {
-    assert(node && memory);
-    mem_entry_t *entry = node->data;
+void split_mem_entry(mem_addr_t start, mem_addr_t process_size,
+        memory_t *memory) {
+    assert(memory);
+    map_iter_t it = map_find(memory->map, start);
+    mem_entry_t *entry = map_entry(memory->map, it);
+    assert(entry);
 
     // unused portion becomes the hole
-    int hole_size = entry->length - process_size;
+    mem_addr_t hole_size = entry->length - process_size;
     assert(hole_size >= 0); // hole must fit
     if (hole_size == 0) // exact fit
         return;
-    
-    entry->length = process_size;
-    // new hole to hold the remaining memory
-    mem_entry_t *new_hole = 
-            create_mem_entry(HOLE, entry->start + process_size, hole_size);
-    double_node_t *new_node = create_double_node(new_hole); // wrap up
 
-    // new hole follows the original (process type) entry
-    insert_behind(node, new_node, memory);
+    entry->length = process_size;
+    // new hole to hold the remaining memory, following the process entry
+    // (`entry` may be moved by the insertion)
+    mem_entry_t new_hole = {HOLE, start + process_size, hole_size, NULL};
+    map_insert_after(memory->map, it, new_hole);
+    index_hole(&new_hole, memory);
 }
 
-/* Deallocates memory for the process, 
-   and merges the adjacent holes in the memory list if possible.
+/* Deallocates memory for the process,
+   and merges the adjacent holes in the memory map if possible.
 */
 void demalloc(process_t *process, memory_t *memory) {
     assert(process);
-    if (!process->address_assigned) {
+    if (process->address_assigned == NOT_ASSIGNED) {
         // no address assigned (e.g. using infinite malloc) -> do nothing
         return;
     }
 
-    merge_adjacent_holes(process->address_assigned, memory);
+    switch (memory->allocator) {
+        case SEGMENT_ALLOCATOR:
+            if (memory->slab && free_slab_slot(memory, process))
+                return;
+            merge_adjacent_holes(process->address_assigned, memory);
+            break;
+        case BUDDY_ALLOCATOR:
+            buddy_free(memory->buddy, process->address_assigned, 
+                    process->memory_requirement);
+            break;
+        case BITMAP_ALLOCATOR:
+            bitmap_free(memory->bitmap, process->address_assigned, 
+                    process->memory_requirement);
+            break;
+        case VIRTUAL_ALLOCATOR:
+            // frames are not allocated for the whole requirement
+            paging_free(memory->paging, process);
+            memory->free = memory->paging->free_frames * PAGE_SIZE;
+            return;
+    }
+    mem_addr_t size = allocated_size(memory, process->memory_requirement);
+    memory->waste -= size - process->memory_requirement;
+    memory->free += size;
 }
 
-/* Merges the adjacent holes to the given node in memory.
- * Frees the memory at the node even if no merging is done.
+/* Merges the adjacent holes to the entry starting at the address.
+ * Frees the memory of the entry even if no merging is done.
  */
-void merge_adjacent_holes(double_node_t *node, memory_t *memory) {
-    assert(node && memory);
-    // data for the new hole
-    mem_entry_t *entry = node->data;
-    int new_hole_length = entry->length;
-    int new_hole_start = entry->start;
+void merge_adjacent_holes(mem_addr_t start, memory_t *memory) {
+    assert(memory);
+    map_iter_t it = map_find(memory->map, start);
+    mem_entry_t *entry = map_entry(memory->map, it);
+    assert(entry);
 
-    mem_entry_t *tmp_entry; // temporary placeholder for a memory entry
-    if (node->prev) {
-        tmp_entry = (mem_entry_t *) node->prev->data;
-        if (tmp_entry->type == HOLE) {
-            // previous node is a hole
-            new_hole_start = tmp_entry->start;
-            new_hole_length += tmp_entry->length;
+    // the entry becomes a hole, even if no merging is done
+    entry->type = HOLE;
+    entry->owner = NULL;
 
-            // previous node no longer needed (merged into this node)
-            delete_double_node(node->prev, memory);
-        }
+    map_iter_t prev_it = map_prev(memory->map, it);
+    mem_entry_t *tmp_entry = map_entry(memory->map, prev_it);
+    if (tmp_entry && tmp_entry->type == HOLE) {
+        // previous entry is a hole -> it absorbs this entry
+        unindex_hole(tmp_entry, memory);
+        map_absorb_next(memory->map, prev_it);
+        it = prev_it;
+    }
+
+    map_iter_t next_it = map_next(memory->map, it);
+    tmp_entry = map_entry(memory->map, next_it);
+    if (tmp_entry && tmp_entry->type == HOLE) {
+        // next entry is a hole -> this entry absorbs it
+        unindex_hole(tmp_entry, memory);
+        map_absorb_next(memory->map, it);
+    }
+
+    entry = map_entry(memory->map, it);
+    index_hole(entry, memory);
+
+    // a rover inside the merged hole moves to its start
+    if (memory->rover > entry->start 
+            && memory->rover < entry->start + entry->length)
+        memory->rover = entry->start;
+}
+
+/* Returns the number of holes (maximal free blocks, runs or segments).
+ */
+int64_t count_holes(memory_t *memory) {
+    assert(memory);
+    int64_t num_holes = 0, longest;
+    switch (memory->allocator) {
+        case SEGMENT_ALLOCATOR:
+            num_holes = memory->holes->count;
+            break;
+        case BUDDY_ALLOCATOR:
+            for (int k = 0; k <= memory->buddy->max_order; k++)
+                num_holes += memory->buddy->free_blocks[k]->count;
+            break;
+        case BITMAP_ALLOCATOR:
+            bitmap_free_runs(memory->bitmap, &num_holes, &longest);
+            break;
+        case VIRTUAL_ALLOCATOR: // any free frames make a single pool
+            num_holes = memory->paging->free_frames > 0;
+            break;
+    }
+    return num_holes;
+}
+
+/* Returns the size of the largest hole.
+ */
+mem_addr_t largest_hole(memory_t *memory) {
+    assert(memory);
+    avl_node_t *largest;
+    int64_t num_runs, longest;
+    switch (memory->allocator) {
+        case SEGMENT_ALLOCATOR:
+            largest = avl_max(memory->holes);
+            return largest ? largest->key.primary : 0;
+        case BUDDY_ALLOCATOR:
+            if (!memory->buddy->nonempty)
+                return 0;
+            // the highest order with a free block
+            return (mem_addr_t) 1 << (63 - __builtin_clzll(
+                    memory->buddy->nonempty));
+        case BITMAP_ALLOCATOR:
+            bitmap_free_runs(memory->bitmap, &num_runs, &longest);
+            return longest * PAGE_SIZE;
+        case VIRTUAL_ALLOCATOR:
+            return memory->paging->free_frames * PAGE_SIZE;
+    }
+    return 0;
+}
+
+/* Returns the largest requirement that could be allocated now.
+ */
+mem_addr_t largest_allocatable(memory_t *memory) {
+    assert(memory);
+    if (memory->allocator == VIRTUAL_ALLOCATOR) {
+        // enough frames (free or evictable) to start any process that 
+        // fits in memory on its own, or else a process of that many pages
+        int64_t frames = paging_available(memory->paging);
+        return frames >= MIN_RESIDENT_PAGES ? 
+                memory->paging->num_frames * PAGE_SIZE : frames * PAGE_SIZE;
+    }
+    if (memory->slab) { // a free slot may be larger than any hole
+        mem_addr_t largest = largest_hole(memory);
+        mem_addr_t slot = slab_largest_free(memory->slab);
+        return slot > largest ? slot : largest;
+    }
+    return largest_hole(memory);
+}
+
+/* Returns the size of the block that freeing the process's memory would 
+   leave (with the holes it would merge with), or 0 if it holds none.
+ * Under the buddy and bitmap allocators, only its own block or pages are
+   counted (not what they would coalesce with).
+ */
+mem_addr_t hole_if_freed(memory_t *memory, process_t *process) {
+    assert(memory && process);
+    if (process->address_assigned == NOT_ASSIGNED)
+        return 0;
+
+    if (memory->allocator == VIRTUAL_ALLOCATOR) {
+        int64_t frames = 
+                paging_available_if_freed(memory->paging, process);
+        // as for `largest_allocatable`
+        return frames >= MIN_RESIDENT_PAGES ? 
+                memory->paging->num_frames * PAGE_SIZE : frames * PAGE_SIZE;
+    }
+    mem_addr_t start;
+    mem_addr_t length = block_if_freed(memory, process, NULL, NULL, &start);
+    if (!length && memory->allocator == SEGMENT_ALLOCATOR) // a slab slot
+        return process->memory_requirement;
+    return length;
+}
+
+/* Returns the size of the block that freeing the process's memory would
+   leave, together with the holes and the memory of the processes (meeting
+   the predicate) next to it, and next to those, and so on; stores its
+   start in `start`. Returns 0 if it holds no such block.
+ * Under the buddy and bitmap allocators, only its own block or pages are
+   counted; a slot in a slab counts as no block.
+ */
+mem_addr_t block_if_freed(memory_t *memory, process_t *process,
+        process_pred_fp_t freed, void *context, mem_addr_t *start) {
+    assert(memory && process && start);
+    *start = process->address_assigned;
+    if (process->address_assigned == NOT_ASSIGNED)
+        return 0;
+    if (memory->allocator != SEGMENT_ALLOCATOR)
+        return allocated_size(memory, process->memory_requirement);
+
+    map_iter_t it = map_find(memory->map, process->address_assigned);
+    mem_entry_t *entry = map_entry(memory->map, it);
+    if (!entry || entry->owner != process) // a slot in a slab
+        return 0;
+    mem_addr_t length = entry->length;
+
+    // extend the block down, then up, over what would be free
+    map_iter_t prev_it = map_prev(memory->map, it);
+    while ((entry = map_entry(memory->map, prev_it))
+            && (entry->type == HOLE || (entry->type == PROCESS
+                && freed && freed(entry->owner, context)))) {
+        *start = entry->start;
+        length += entry->length;
+        prev_it = map_prev(memory->map, prev_it);
+    }
+    map_iter_t next_it = map_next(memory->map, it);
+    while ((entry = map_entry(memory->map, next_it))
+            && (entry->type == HOLE || (entry->type == PROCESS
+                && freed && freed(entry->owner, context)))) {
+        length += entry->length;
+        next_it = map_next(memory->map, next_it);
+    }
+    return length;
+}
+
+/* Returns the external fragmentation of memory: the share of free memory
+   lying outside the largest hole (0 if nothing is free).
+ */
+double external_fragmentation(memory_t *memory) {
+    assert(memory);
+    if (memory->free == 0)
+        return 0;
+    return 1 - (double) largest_hole(memory) / memory->free;
+}
+
+/* Enables the TLSF index of the holes of segment memory.
+ */
+void enable_tlsf(memory_t *memory) {
+    assert(memory && memory->allocator == SEGMENT_ALLOCATOR);
+    if (memory->tlsf)
+        return;
+    memory->tlsf = create_tlsf();
+
+    mem_entry_t *entry;
+    for (map_iter_t it = map_first(memory->map); 
+            (entry = map_entry(memory->map, it)); 
+            it = map_next(memory->map, it)) {
+        if (entry->type == HOLE)
+            tlsf_insert(memory->tlsf, entry->start, entry->length);
+    }
+}
+
+/* Enables slabs for the recurring sizes of processes in segment memory.
+ */
+void enable_slab(memory_t *memory) {
+    assert(memory && memory->allocator == SEGMENT_ALLOCATOR);
+    if (!memory->slab)
+        memory->slab = create_slab_allocator();
+}
+
+/* Enables the (address-ordered) hole array of segment memory.
+ */
+void enable_hole_array(memory_t *memory) {
+    assert(memory && memory->allocator == SEGMENT_ALLOCATOR);
+    if (memory->hole_array)
+        return;
+    memory->hole_array = create_hole_array();
+
+    mem_entry_t *entry;
+    for (map_iter_t it = map_first(memory->map); 
+            (entry = map_entry(memory->map, it)); 
+            it = map_next(memory->map, it)) {
+        if (entry->type == HOLE)
+            hole_array_insert(memory->hole_array, entry->start, 
+                    entry->length);
     }
+}
+
+/* Enables compaction of segment memory, when an allocation fails and 
+   the external fragmentation is at least the threshold (in [0, 1]).
+ */
+void enable_compaction(memory_t *memory, double threshold) {
+    assert(memory && threshold >= 0 && threshold <= 1);
+    memory->compaction_threshold = threshold;
+}
+
+/* Compacts the memory if compaction is enabled and would let the 
+   requirement fit: it fits in the total free memory but in no hole, 
+   and the external fragmentation reaches the threshold.
+ * Returns TRUE (1) if the memory was compacted, FALSE (0) otherwise.
+ */
+int compact_if_fragmented(memory_t *memory, mem_addr_t requirement) {
+    assert(memory);
+    if (memory->allocator != SEGMENT_ALLOCATOR 
+            || memory->compaction_threshold == NO_COMPACTION
+            || memory->slab // slabs cannot move: processes hold their slots
+            || requirement > memory->free)
+        return 0;
+
+    if (largest_hole(memory) >= requirement)
+        return 0; // a hole already fits
+    if (external_fragmentation(memory) < memory->compaction_threshold)
+        return 0;
+
+    compact_memory(memory);
+    return 1;
+}
+
+/* Slides all process entries of segment memory down to the lowest 
+   addresses (updating their processes' assigned addresses), 
+   leaving a single hole at the top.
+ * Returns the total size of the entries moved.
+ */
+mem_addr_t compact_memory(memory_t *memory) {
+    assert(memory && memory->allocator == SEGMENT_ALLOCATOR);
+    memory_map_t *map = memory->map;
 
-    if (node->next) {
-        tmp_entry = (mem_entry_t *) node->next->data;
-        if (tmp_entry->type == HOLE) {
-            // next node is a hole
-            new_hole_length += tmp_entry->length;
-            // next node no longer needed
-            delete_double_node(node->next, memory);
+    // pack the process entries (in address order), then the hole
+    mem_entry_t *packed = malloc((map->count + 1) * sizeof(*packed));
+    assert(packed);
+    int count = 0;
+    mem_addr_t next_start = 0, moved = 0;
+    mem_entry_t *entry;
+    for (map_iter_t it = map_first(map); (entry = map_entry(map, it)); 
+            it = map_next(map, it)) {
+        if (entry->type != PROCESS)
+            continue;
+        packed[count] = *entry;
+        if (entry->start != next_start) { // slide down
+            moved += entry->length;
+            packed[count].start = next_start;
+            entry->owner->address_assigned = next_start;
         }
+        next_start += entry->length;
+        count++;
     }
 
-    // replace data in the current node, as if it's a new hole node
-    // (these steps are performed even if no merging was done)
-    entry->length = new_hole_length;
-    entry->start = new_hole_start;
-    entry->type = HOLE;
+    free_avl(memory->holes);
+    memory->holes = make_empty_avl();
+    if (memory->tlsf) {
+        free_tlsf(memory->tlsf);
+        memory->tlsf = create_tlsf();
+    }
+    if (memory->hole_array)
+        memory->hole_array->count = 0;
+    if (next_start < memory->capacity) {
+        mem_entry_t hole = {HOLE, next_start, memory->capacity - next_start, 
+                NULL};
+        packed[count++] = hole;
+        index_hole(&hole, memory);
+    }
+
+    memory->map = make_memory_map(map->type, packed, count);
+    free_memory_map(map);
+    free(packed);
+    packed = NULL;
+
+    memory->rover = next_start; // next fit resumes at the hole
+    memory->num_compactions++;
+    memory->compaction_moved += moved;
+    return moved;
 }
 
-/* Frees the memory. 
+/* Returns the current internal fragmentation, i.e. the memory allocated to
+   processes beyond their requirements.
+ */
+mem_addr_t internal_waste(memory_t *memory) {
+    assert(memory);
+    return memory->waste;
+}
+
+/* Frees the memory.
  */
 void free_memory(memory_t *memory) {
     assert(memory);
-    // memory should be a single hole node in the end, 
-    // once all processes are completed
-    free(memory->head->data);
-    memory->head->data = NULL;
-    free(memory->head);
-    memory->head = NULL;
+    if (memory->map) {
+        // memory should be a single hole entry in the end,
+        // once all processes are completed
+        free_memory_map(memory->map);
+        memory->map = NULL;
+        free_avl(memory->holes);
+        memory->holes = NULL;
+    }
+    if (memory->tlsf) {
+        free_tlsf(memory->tlsf);
+        memory->tlsf = NULL;
+    }
+    if (memory->hole_array) {
+        free_hole_array(memory->hole_array);
+        memory->hole_array = NULL;
+    }
+    if (memory->slab) {
+        free_slab_allocator(memory->slab);
+        memory->slab = NULL;
+    }
+    if (memory->buddy) {
+        free_buddy(memory->buddy);
+        memory->buddy = NULL;
+    }
+    if (memory->bitmap) {
+        free_bitmap(memory->bitmap);
+        memory->bitmap = NULL;
+    }
+    if (memory->paging) {
+        free_paging(memory->paging);
+        memory->paging = NULL;
+    }
     free(memory);
     memory = NULL;
 }
\ No newline at end of file
@@ -2,66 +2,247 @@
  * Project 1
  * Created by Angel He (angelh1@student.unimelb.edu.au) 25/03/2023
  * memory.h :
-              = the interface of the module `memory` of the project 
-              = simulates memory in the form of a doubly-linked list
+              = the interface of the module `memory` of the project
+              = simulates memory in the form of an address-ordered map
+                of entries (see `memory_map`), with its holes indexed by size
  ----------------------------------------------------------------------------*/
 
 #ifndef _MEMORY_H_
 #define _MEMORY_H_
 
 #include "process_data.h"
-#include "doubly_linked_list.h"
+#include "memory_map.h"
+#include "avl_tree.h"
+#include "buddy.h"
+#include "bitmap.h"
+#include "paging.h"
+#include "tlsf.h"
+#include "hole_array.h"
+#include "slab.h"
+
+#define DEFAULT_MEMORY_CAPACITY 2048  // default memory capacity in MB
+#define NO_COMPACTION -1              // compaction threshold: never compact
+
+/* the ways memory can be carved up between processes */
+enum memory_allocator {
+    SEGMENT_ALLOCATOR,   // variable-sized segments (entries of the map)
+    BUDDY_ALLOCATOR,     // power-of-two blocks
+    BITMAP_ALLOCATOR,    // runs of fixed-size pages
+    VIRTUAL_ALLOCATOR    // pages, not all of which need to be in memory
+};
 
-#define MEMORY_CAPACITY 2048  // memory capacity in MB
-#define PROCESS 1             // process type entry (occupied memory)
-#define HOLE 0                // hole type entry (free memory)
-
-/* data held in a node of the memory 'list' */
 typedef struct {
-    int type;    // PROCESS or HOLE
-    int start;   // starting address
-    int length;  // size of this entry
-} mem_entry_t;
+    mem_addr_t capacity; // memory capacity in MB
+    enum memory_allocator allocator;
+
+    /* SEGMENT_ALLOCATOR */
+    memory_map_t *map;   // memory entries, ordered by address
+    avl_tree_t *holes;   // holes, keyed by (length, start)
+    mem_addr_t rover;    // start of the entry where next fit resumes
+    tlsf_t *tlsf;        // holes, by size class (NULL unless enabled)
+    hole_array_t *hole_array; // holes, packed (NULL unless enabled)
+    slab_allocator_t *slab; // slabs for recurring sizes (NULL unless enabled)
+    double compaction_threshold; // external fragmentation to compact at
+
+    /* BUDDY_ALLOCATOR */
+    buddy_t *buddy;
+
+    /* BITMAP_ALLOCATOR */
+    bitmap_t *bitmap;
+
+    /* VIRTUAL_ALLOCATOR */
+    paging_t *paging;
+
+    mem_addr_t free;             // total free memory
+    mem_addr_t min_free;         // least free memory at any time
+
+    /* allocation attempts */
+    long num_attempts;
+    long num_failures;
+    long segments_scanned;       // entries (or index nodes) examined
+    long max_scanned;            // most examined by a single attempt
+
+    /* compaction cost */
+    int num_compactions;
+    mem_addr_t compaction_moved; // total size of the entries moved
 
-typedef doubly_linked_list_t memory_t; // memory as a doubly-linked list
+    /* internal fragmentation (allocated space not requested by processes) */
+    mem_addr_t waste;            // currently wasted
+    mem_addr_t max_waste;        // peak wasted
+    mem_addr_t total_requested;  // over all allocations
+    mem_addr_t total_allocated;  // over all allocations
+} memory_t;
+
+/* function pointer type for allocating memory to a process */
+typedef void (*process_allocator_fp_t) (memory_t *, process_t *);
+
+/* function pointer type for telling whether the memory of a process is
+   to be counted as freed (given some context) */
+typedef int (*process_pred_fp_t) (process_t *, void *);
 
 
 /************** function declarations **************/
 
-/* Creates a memory entry with the given type, starting address and length.
+/* Creates, initializes, and returns the memory structure of the given 
+   capacity (in MB), managed by the given allocator.
+ * Segments are stored in a map of the given type.
  */
-mem_entry_t *create_mem_entry(int type, int start, int length);
+memory_t *initialize_memory(enum memory_allocator allocator, 
+        enum map_type map_type, mem_addr_t capacity);
 
-/* Creates, initializes, and returns the memory structure.
+/* Allocates memory to the process by best fit
+   (the smallest hole that fits, with the lowest address on ties).
  */
-memory_t *initialize_memory();
+void malloc_by_best_fit(memory_t *memory, process_t *process);
 
-/* Allocates memory to the process by best fit.
+/* Allocates memory to the process by first fit
+   (the lowest-addressed hole that fits).
+ * The hole array must be enabled.
  */
-void malloc_by_best_fit(memory_t *memory, process_t *process);
+void malloc_by_first_fit(memory_t *memory, process_t *process);
 
-/* Allocates the node (in the given memory list) to the process.
+/* Allocates memory to the process by next fit
+   (the first hole that fits, searching on from the previous allocation).
+ * The hole array must be enabled.
  */
-void allocate_process(double_node_t *node, process_t *process, 
-        memory_t *memory);
+void malloc_by_next_fit(memory_t *memory, process_t *process);
+
+/* Allocates memory to the process by worst fit
+   (the largest hole, with the lowest address on ties).
+ */
+void malloc_by_worst_fit(memory_t *memory, process_t *process);
+
+/* Allocates memory to the process from a slab for its size, reserving a
+   new slab (by best fit) if none has a free slot; sizes without slabs 
+   are allocated by best fit.
+ * Slabs must be enabled.
+ */
+void malloc_by_slab(memory_t *memory, process_t *process);
+
+/* Allocates memory to the process by the buddy system.
+ */
+void malloc_by_buddy(memory_t *memory, process_t *process);
+
+/* Allocates memory to the process as a run of pages in the bitmap.
+ */
+void malloc_by_bitmap(memory_t *memory, process_t *process);
+
+/* Allocates memory to the process by two-level segregated fit
+   (a hole of the smallest size class that is sure to fit).
+ * TLSF must be enabled.
+ */
+void malloc_by_tlsf(memory_t *memory, process_t *process);
+
+/* Allocates memory to the process as pages of virtual memory,
+   not all of which need to be in frames.
+ */
+void malloc_by_virtual(memory_t *memory, process_t *process);
+
+/* Swaps in the pages of the process (about to run) under virtual memory,
+   keeping them in memory until it is out of use (or finished).
+ * Returns the number of pages swapped in (0 under other allocators).
+ */
+int64_t page_in_process(memory_t *memory, process_t *process);
+
+/* Lets the pages of the process (no longer running, but not finished) 
+   be evicted again under virtual memory.
+ * Returns TRUE (1) if it holds pages that are now evictable, 
+   FALSE (0) otherwise.
+ */
+int page_out_of_use(memory_t *memory, process_t *process);
 
-/* Splits the memory entry held in the node into two:
-   - a process type of the given size, and 
+/* Allocates the hole starting at the address to the process.
+ */
+void allocate_process(mem_addr_t start, process_t *process, memory_t *memory);
+
+/* Splits the memory entry starting at the address into two:
+   - a process type of the given size, and
    - a hole type (if necessary), following the process entry.
  */
-void split_mem_entry(double_node_t *node, int process_size, memory_t *memory);
+void split_mem_entry(mem_addr_t start, mem_addr_t process_size,
+        memory_t *memory);
 
-/* Deallocates memory for the process, 
-   and merges the adjacent holes in the memory list if possible.
+/* Deallocates memory for the process,
+   and merges the adjacent holes in the memory map if possible.
 */
 void demalloc(process_t *process, memory_t *memory);
 
-/* Merges the adjacent holes to the given node in memory.
- * Frees the memory at the node even if no merging is done.
+/* Merges the adjacent holes to the entry starting at the address.
+ * Frees the memory of the entry even if no merging is done.
+ */
+void merge_adjacent_holes(mem_addr_t start, memory_t *memory);
+
+/* Returns the number of holes (maximal free blocks, runs or segments).
+ */
+int64_t count_holes(memory_t *memory);
+
+/* Returns the size of the largest hole.
+ */
+mem_addr_t largest_hole(memory_t *memory);
+
+/* Returns the largest requirement that could be allocated now.
+ */
+mem_addr_t largest_allocatable(memory_t *memory);
+
+/* Returns the size of the block that freeing the process's memory would 
+   leave (with the holes it would merge with), or 0 if it holds none.
+ * Under the buddy and bitmap allocators, only its own block or pages are
+   counted (not what they would coalesce with).
+ */
+mem_addr_t hole_if_freed(memory_t *memory, process_t *process);
+
+/* Returns the size of the block that freeing the process's memory would
+   leave, together with the holes and the memory of the processes (meeting
+   the predicate) next to it, and next to those, and so on; stores its
+   start in `start`. Returns 0 if it holds no such block.
+ * Under the buddy and bitmap allocators, only its own block or pages are
+   counted; a slot in a slab counts as no block.
+ */
+mem_addr_t block_if_freed(memory_t *memory, process_t *process,
+        process_pred_fp_t freed, void *context, mem_addr_t *start);
+
+/* Returns the external fragmentation of memory: the share of free memory
+   lying outside the largest hole (0 if nothing is free).
+ */
+double external_fragmentation(memory_t *memory);
+
+/* Enables the TLSF index of the holes of segment memory.
+ */
+void enable_tlsf(memory_t *memory);
+
+/* Enables slabs for the recurring sizes of processes in segment memory.
+ */
+void enable_slab(memory_t *memory);
+
+/* Enables the (address-ordered) hole array of segment memory.
+ */
+void enable_hole_array(memory_t *memory);
+
+/* Enables compaction of segment memory, when an allocation fails and 
+   the external fragmentation is at least the threshold (in [0, 1]).
+ */
+void enable_compaction(memory_t *memory, double threshold);
+
+/* Compacts the memory if compaction is enabled and would let the 
+   requirement fit: it fits in the total free memory but in no hole, 
+   and the external fragmentation reaches the threshold.
+ * Returns TRUE (1) if the memory was compacted, FALSE (0) otherwise.
+ */
+int compact_if_fragmented(memory_t *memory, mem_addr_t requirement);
+
+/* Slides all process entries of segment memory down to the lowest 
+   addresses (updating their processes' assigned addresses), 
+   leaving a single hole at the top.
+ * Returns the total size of the entries moved.
+ */
+mem_addr_t compact_memory(memory_t *memory);
+
+/* Returns the current internal fragmentation, i.e. the memory allocated to
+   processes beyond their requirements.
  */
-void merge_adjacent_holes(double_node_t *node, memory_t *memory);
+mem_addr_t internal_waste(memory_t *memory);
 
-/* Frees the memory. 
+/* Frees the memory.
  */
 void free_memory(memory_t *memory);
 
@@ -0,0 +1,234 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * memory_map.c :
+              = the implementation of the module `memory_map` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "memory_map.h"
+
+/* some 'private' helper functions */
+static map_iter_t list_iter(double_node_t *node);
+static map_iter_t array_iter(int index);
+static avl_key_t start_key(mem_addr_t start);
+static double_node_t *create_entry_node(mem_entry_t entry);
+
+
+/* Creates a memory entry with the given type, starting address and length.
+ */
+mem_entry_t *create_mem_entry(int type, mem_addr_t start, mem_addr_t length) {
+    mem_entry_t *entry = malloc(sizeof(*entry));
+    assert(entry);
+
+    entry->type = type;
+    entry->start = start;
+    entry->length = length;
+    entry->owner = NULL;
+
+    return entry;
+}
+
+/* Creates and returns a memory map of the given type,
+   holding (copies of) the `count` entries, sorted by address.
+ */
+memory_map_t *make_memory_map(enum map_type type, mem_entry_t *entries, 
+        int count) {
+    assert(entries && count > 0);
+    memory_map_t *map = malloc(sizeof(*map));
+    assert(map);
+    map->type = type;
+    map->count = count;
+    map->list = NULL;
+    map->by_start = NULL;
+    map->array = NULL;
+    map->size = 0;
+
+    if (type == LIST_MAP) {
+        map->list = make_empty_dll();
+        map->by_start = make_empty_avl();
+        for (int i = 0; i < count; i++) {
+            double_node_t *node = create_entry_node(entries[i]);
+            insert_at_dll_foot(map->list, node);
+            avl_insert(map->by_start, start_key(entries[i].start), node);
+        }
+    } else {
+        map->size = INITIAL_ARRAY_SIZE;
+        while (map->size < count)
+            map->size *= 2;
+        map->array = malloc(map->size * sizeof(*map->array));
+        assert(map->array);
+        memcpy(map->array, entries, count * sizeof(*map->array));
+    }
+
+    return map;
+}
+
+/* Helper function to return a new list node holding a copy of the entry.
+ */
+static double_node_t *create_entry_node(mem_entry_t entry) {
+    mem_entry_t *copy = create_mem_entry(entry.type, entry.start, 
+            entry.length);
+    copy->owner = entry.owner;
+    return create_double_node(copy);
+}
+
+/* Helper function to return the position of a list node.
+ */
+static map_iter_t list_iter(double_node_t *node) {
+    map_iter_t it = {node, -1};
+    return it;
+}
+
+/* Helper function to return the position of an array index.
+ */
+static map_iter_t array_iter(int index) {
+    map_iter_t it = {NULL, index};
+    return it;
+}
+
+/* Helper function to return the key of a list node in the start index.
+ */
+static avl_key_t start_key(mem_addr_t start) {
+    return make_avl_key(start, 0);
+}
+
+/* Returns the entry at the position, or NULL if the position is invalid
+   (e.g. past either end of the map).
+ */
+mem_entry_t *map_entry(memory_map_t *map, map_iter_t it) {
+    assert(map);
+    if (map->type == LIST_MAP)
+        return it.node ? it.node->data : NULL;
+    if (it.index < 0 || it.index >= map->count)
+        return NULL;
+    return &map->array[it.index];
+}
+
+/* Returns the position of the first (lowest address) entry.
+ */
+map_iter_t map_first(memory_map_t *map) {
+    assert(map);
+    if (map->type == LIST_MAP)
+        return list_iter(map->list->head);
+    return array_iter(0);
+}
+
+/* Returns the position of the entry following the one at `it`.
+ */
+map_iter_t map_next(memory_map_t *map, map_iter_t it) {
+    assert(map);
+    if (map->type == LIST_MAP)
+        return list_iter(it.node ? it.node->next : NULL);
+    return array_iter(it.index + 1);
+}
+
+/* Returns the position of the entry preceding the one at `it`.
+ */
+map_iter_t map_prev(memory_map_t *map, map_iter_t it) {
+    assert(map);
+    if (map->type == LIST_MAP)
+        return list_iter(it.node ? it.node->prev : NULL);
+    return array_iter(it.index - 1);
+}
+
+/* Returns the position of the entry starting at the address,
+   or an invalid position if there is none.
+ */
+map_iter_t map_find(memory_map_t *map, mem_addr_t start) {
+    assert(map);
+    if (map->type == LIST_MAP) {
+        avl_node_t *found = avl_find(map->by_start, start_key(start));
+        return list_iter(found ? found->data : NULL);
+    }
+
+    // binary search over the sorted array
+    int low = 0, high = map->count - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        if (map->array[mid].start == start)
+            return array_iter(mid);
+        if (map->array[mid].start < start)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return array_iter(-1);
+}
+
+/* Inserts the entry right after the one at `it`,
+   and returns the position of the new entry.
+ */
+map_iter_t map_insert_after(memory_map_t *map, map_iter_t it,
+        mem_entry_t entry) {
+    assert(map && map_entry(map, it));
+    map->count++;
+
+    if (map->type == LIST_MAP) {
+        double_node_t *new = create_entry_node(entry);
+        insert_behind(it.node, new, map->list);
+        avl_insert(map->by_start, start_key(entry.start), new);
+        return list_iter(new);
+    }
+
+    if (map->count > map->size) { // out of slots
+        map->size *= 2;
+        map->array = realloc(map->array, map->size * sizeof(*map->array));
+        assert(map->array);
+    }
+    // shift the following entries up by one slot
+    int index = it.index + 1;
+    memmove(&map->array[index + 1], &map->array[index],
+            (map->count - 1 - index) * sizeof(*map->array));
+    map->array[index] = entry;
+    return array_iter(index);
+}
+
+/* Merges the entry following the one at `it` into it
+   (extending its length), and removes the following entry.
+ * `it` remains valid.
+ */
+void map_absorb_next(memory_map_t *map, map_iter_t it) {
+    assert(map);
+    mem_entry_t *entry = map_entry(map, it);
+    map_iter_t next_it = map_next(map, it);
+    mem_entry_t *next = map_entry(map, next_it);
+    assert(entry && next);
+
+    entry->length += next->length;
+    map->count--;
+
+    if (map->type == LIST_MAP) {
+        avl_delete(map->by_start, start_key(next->start));
+        delete_double_node(next_it.node, map->list); // frees `next`
+        return;
+    }
+
+    // shift the following entries down by one slot
+    memmove(&map->array[next_it.index], &map->array[next_it.index + 1],
+            (map->count - next_it.index) * sizeof(*map->array));
+}
+
+/* Frees all memory allocated to the memory map.
+ */
+void free_memory_map(memory_map_t *map) {
+    assert(map);
+    if (map->type == LIST_MAP) {
+        double_node_t *curr = map->list->head;
+        while (curr) { // the entries are owned by the map
+            free(curr->data);
+            curr->data = NULL;
+            curr = curr->next;
+        }
+        free_dll(map->list);
+        map->list = NULL;
+        free_avl(map->by_start);
+        map->by_start = NULL;
+    } else {
+        free(map->array);
+        map->array = NULL;
+    }
+    free(map);
+    map = NULL;
+}
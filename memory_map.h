@@ -0,0 +1,105 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * memory_map.h :
+              = the interface of the module `memory_map` of the project
+              = stores the memory entries (processes and holes) of the
+                simulated memory in address order, either as a
+                doubly-linked list or as a contiguous sorted array
+ ----------------------------------------------------------------------------*/
+
+#ifndef _MEMORY_MAP_H_
+#define _MEMORY_MAP_H_
+
+#include "process_data.h"
+#include "doubly_linked_list.h"
+#include "avl_tree.h"
+
+#define PROCESS 1             // process type entry (occupied memory)
+#define HOLE 0                // hole type entry (free memory)
+#define SLAB_REGION 2         // slab type entry (reserved for a size)
+
+#define INITIAL_ARRAY_SIZE 16 // initial number of slots of an array map
+
+/* data held in an entry of the memory map */
+typedef struct {
+    int type;           // PROCESS, HOLE or SLAB_REGION
+    mem_addr_t start;   // starting address
+    mem_addr_t length;  // size of this entry
+    process_t *owner;   // the process holding a PROCESS entry
+} mem_entry_t;
+
+enum map_type {LIST_MAP, ARRAY_MAP};  // representations of the memory map
+
+typedef struct {
+    enum map_type type;
+    int count;             // number of entries in the map
+
+    /* LIST_MAP: one node (and entry) per segment */
+    doubly_linked_list_t *list;
+    avl_tree_t *by_start;  // list nodes, keyed by (start, 0)
+
+    /* ARRAY_MAP: entries stored contiguously, sorted by start */
+    mem_entry_t *array;
+    int size;              // number of slots allocated
+} memory_map_t;
+
+/* position of an entry in a memory map;
+   only valid until the map is next modified (except by `map_absorb_next`) */
+typedef struct {
+    double_node_t *node;   // LIST_MAP: the node holding the entry
+    int index;             // ARRAY_MAP: the index of the entry
+} map_iter_t;
+
+
+/************** function declarations **************/
+
+/* Creates a memory entry with the given type, starting address and length.
+ */
+mem_entry_t *create_mem_entry(int type, mem_addr_t start, mem_addr_t length);
+
+/* Creates and returns a memory map of the given type,
+   holding (copies of) the `count` entries, sorted by address.
+ */
+memory_map_t *make_memory_map(enum map_type type, mem_entry_t *entries, 
+        int count);
+
+/* Returns the entry at the position, or NULL if the position is invalid
+   (e.g. past either end of the map).
+ */
+mem_entry_t *map_entry(memory_map_t *map, map_iter_t it);
+
+/* Returns the position of the first (lowest address) entry.
+ */
+map_iter_t map_first(memory_map_t *map);
+
+/* Returns the position of the entry following the one at `it`.
+ */
+map_iter_t map_next(memory_map_t *map, map_iter_t it);
+
+/* Returns the position of the entry preceding the one at `it`.
+ */
+map_iter_t map_prev(memory_map_t *map, map_iter_t it);
+
+/* Returns the position of the entry starting at the address,
+   or an invalid position if there is none.
+ */
+map_iter_t map_find(memory_map_t *map, mem_addr_t start);
+
+/* Inserts the entry right after the one at `it`,
+   and returns the position of the new entry.
+ */
+map_iter_t map_insert_after(memory_map_t *map, map_iter_t it,
+        mem_entry_t entry);
+
+/* Merges the entry following the one at `it` into it
+   (extending its length), and removes the following entry.
+ * `it` remains valid.
+ */
+void map_absorb_next(memory_map_t *map, map_iter_t it);
+
+/* Frees all memory allocated to the memory map.
+ */
+void free_memory_map(memory_map_t *map);
+
+
+#endif
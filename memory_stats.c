@@ -0,0 +1,113 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * memory_stats.c :
+              = the implementation of the module `memory_stats` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include "memory_stats.h"
+
+
+/* Creates and returns the memory statistics, 
+   writing the time series to the given file.
+ */
+memory_stats_t *create_memory_stats(FILE *series) {
+    assert(series);
+    memory_stats_t *stats = malloc(sizeof(*stats));
+    assert(stats);
+
+    stats->series = series;
+    stats->last_attempts = stats->last_failures = stats->last_scanned = 0;
+    stats->num_samples = 0;
+    stats->min_free = stats->min_largest_hole = 0;
+    stats->total_free = stats->total_largest_hole = 0;
+    stats->max_fragmentation = stats->total_fragmentation = 0;
+
+    fprintf(stats->series, MEMORY_STATS_HEADER);
+    return stats;
+}
+
+/* Samples the state of the memory (over all `num_banks` banks) at the 
+   given time, writing a row of the time series.
+ * The allocation counters in the row are those since the previous sample.
+ */
+void sample_memory(memory_stats_t *stats, memory_t **banks, int num_banks,
+        uint32_t time) {
+    assert(stats && banks);
+    int64_t num_holes = 0;
+    mem_addr_t largest = 0, free = 0;
+    long attempts = 0, failures = 0, scanned = 0;
+    for (int i = 0; i < num_banks; i++) {
+        memory_t *memory = banks[i];
+        mem_addr_t bank_largest = largest_hole(memory);
+        num_holes += count_holes(memory);
+        if (bank_largest > largest)
+            largest = bank_largest;
+        free += memory->free;
+        attempts += memory->num_attempts;
+        failures += memory->num_failures;
+        scanned += memory->segments_scanned;
+    }
+    // (no hole spans two banks)
+    double fragmentation = free ? 1 - (double) largest / free : 0;
+
+    fprintf(stats->series, "%u,%" PRId64 ",%" PRI_ADDR ",%" PRI_ADDR 
+            ",%.4lf,%ld,%ld,%ld\n", time, num_holes, largest, free, 
+            fragmentation, attempts - stats->last_attempts, 
+            failures - stats->last_failures, scanned - stats->last_scanned);
+    stats->last_attempts = attempts;
+    stats->last_failures = failures;
+    stats->last_scanned = scanned;
+
+    if (!stats->num_samples || free < stats->min_free)
+        stats->min_free = free;
+    if (!stats->num_samples || largest < stats->min_largest_hole)
+        stats->min_largest_hole = largest;
+    if (fragmentation > stats->max_fragmentation)
+        stats->max_fragmentation = fragmentation;
+    stats->total_free += free;
+    stats->total_largest_hole += largest;
+    stats->total_fragmentation += fragmentation;
+    stats->num_samples++;
+}
+
+/* Prints the summary of the memory statistics 
+   (over all `num_banks` banks).
+ */
+void print_memory_stats(memory_stats_t *stats, memory_t **banks, 
+        int num_banks) {
+    assert(stats && banks);
+    long samples = stats->num_samples ? stats->num_samples : 1;
+    long attempts = 0, failures = 0, scanned = 0, max_scanned = 0;
+    for (int i = 0; i < num_banks; i++) {
+        attempts += banks[i]->num_attempts;
+        failures += banks[i]->num_failures;
+        scanned += banks[i]->segments_scanned;
+        if (banks[i]->max_scanned > max_scanned)
+            max_scanned = banks[i]->max_scanned;
+    }
+
+    printf("Allocations %ld %ld\n", attempts, failures);
+    // average and maximum entries examined per attempt
+    printf("Segments scanned %.2lf %ld\n", 
+            attempts ? (double) scanned / attempts : 0, max_scanned);
+    // minimum and average over all cycles
+    printf("Free memory %" PRI_ADDR " %.2lf\n", stats->min_free, 
+            stats->total_free / samples);
+    printf("Largest hole %" PRI_ADDR " %.2lf\n", stats->min_largest_hole, 
+            stats->total_largest_hole / samples);
+    // maximum and average over all cycles
+    printf("External fragmentation %.2lf %.2lf\n", stats->max_fragmentation, 
+            stats->total_fragmentation / samples);
+}
+
+/* Frees all memory allocated to the statistics (closing the file).
+ */
+void free_memory_stats(memory_stats_t *stats) {
+    assert(stats);
+    fclose(stats->series);
+    stats->series = NULL;
+    free(stats);
+    stats = NULL;
+}
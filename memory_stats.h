@@ -0,0 +1,64 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * memory_stats.h :
+              = the interface of the module `memory_stats` of the project
+              = samples the state of the memory once per cycle, writing
+                a time series and keeping a summary
+ ----------------------------------------------------------------------------*/
+
+#ifndef _MEMORY_STATS_H_
+#define _MEMORY_STATS_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "memory.h"
+
+/* header of the time series (one row per cycle) */
+#define MEMORY_STATS_HEADER "time,holes,largest_hole,free," \
+        "external_fragmentation,attempts,failures,scanned\n"
+
+typedef struct {
+    FILE *series;               // where the time series is written
+
+    /* allocation counters at the previous sample */
+    long last_attempts;
+    long last_failures;
+    long last_scanned;
+
+    /* summary over all samples */
+    long num_samples;
+    mem_addr_t min_free;
+    double total_free;
+    mem_addr_t min_largest_hole;
+    double total_largest_hole;
+    double max_fragmentation;
+    double total_fragmentation;
+} memory_stats_t;
+
+
+/************** function declarations **************/
+
+/* Creates and returns the memory statistics, 
+   writing the time series to the given file.
+ */
+memory_stats_t *create_memory_stats(FILE *series);
+
+/* Samples the state of the memory (over all `num_banks` banks) at the 
+   given time, writing a row of the time series.
+ * The allocation counters in the row are those since the previous sample.
+ */
+void sample_memory(memory_stats_t *stats, memory_t **banks, int num_banks,
+        uint32_t time);
+
+/* Prints the summary of the memory statistics 
+   (over all `num_banks` banks).
+ */
+void print_memory_stats(memory_stats_t *stats, memory_t **banks, 
+        int num_banks);
+
+/* Frees all memory allocated to the statistics (closing the file).
+ */
+void free_memory_stats(memory_stats_t *stats);
+
+
+#endif
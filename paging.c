@@ -0,0 +1,188 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * paging.c :
+              = the implementation of the module `paging` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include "paging.h"
+
+/* some 'private' helper functions */
+static avl_key_t lru_key(process_t *process);
+static void mark_used(paging_t *paging, process_t *process);
+static void lru_insert(paging_t *paging, process_t *process);
+static int lru_delete(paging_t *paging, process_t *process);
+static void evict(paging_t *paging, int64_t frames);
+
+
+/* Creates and returns the virtual memory over the frames of memory of 
+   the given capacity (in MB), initially free.
+ */
+paging_t *create_paging(mem_addr_t capacity) {
+    assert(capacity > 0);
+    paging_t *paging = malloc(sizeof(*paging));
+    assert(paging);
+
+    paging->num_frames = capacity / PAGE_SIZE; // a partial frame is unusable
+    paging->free_frames = paging->num_frames;
+    paging->lru = make_empty_avl();
+    paging->evictable_frames = 0;
+    paging->clock = 0;
+    paging->page_faults = paging->evictions = 0;
+
+    return paging;
+}
+
+/* Helper function to return the key of a process in the LRU index.
+ */
+static avl_key_t lru_key(process_t *process) {
+    return make_avl_key(process->last_used, 0);
+}
+
+/* Helper function to (re-)index the process, holding frames, 
+   as the most recently used.
+ */
+static void mark_used(paging_t *paging, process_t *process) {
+    process->last_used = ++paging->clock;
+    lru_insert(paging, process);
+}
+
+/* Helper function to add the process (holding frames) to the LRU index,
+   letting its pages be evicted.
+ */
+static void lru_insert(paging_t *paging, process_t *process) {
+    avl_insert(paging->lru, lru_key(process), process);
+    paging->evictable_frames += process->pages_resident;
+}
+
+/* Helper function to remove the process from the LRU index.
+ * Returns FALSE (0) if it was not there (being pinned), TRUE (1) otherwise.
+ */
+static int lru_delete(paging_t *paging, process_t *process) {
+    if (!avl_delete(paging->lru, lru_key(process)))
+        return 0;
+    paging->evictable_frames -= process->pages_resident;
+    return 1;
+}
+
+/* Helper function to evict pages of the least recently used processes
+   until the given number of frames are free (or no pages are evictable).
+ */
+static void evict(paging_t *paging, int64_t frames) {
+    while (paging->free_frames < frames) {
+        avl_node_t *lru = avl_min(paging->lru);
+        if (!lru) // the rest are pinned
+            return;
+        process_t *victim = lru->data;
+        int64_t evicted = frames - paging->free_frames;
+        if (evicted > victim->pages_resident)
+            evicted = victim->pages_resident;
+
+        victim->pages_resident -= evicted;
+        paging->evictable_frames -= evicted;
+        paging->free_frames += evicted;
+        paging->evictions += evicted;
+        if (!victim->pages_resident)
+            avl_delete(paging->lru, lru_key(victim));
+    }
+}
+
+/* Admits the process with as many of its pages as there are free frames,
+   provided that is at least MIN_RESIDENT_PAGES (or all its pages), 
+   evicting pages of the least recently used processes (not pinned) 
+   to free that many if needed.
+ * Returns the start of its (own) virtual address space, 
+   or NOT_ASSIGNED if it cannot be admitted.
+ */
+mem_addr_t paging_alloc(paging_t *paging, process_t *process) {
+    assert(paging && process);
+    int64_t pages = pages_needed(process->memory_requirement);
+    int64_t min_pages = 
+            pages < MIN_RESIDENT_PAGES ? pages : MIN_RESIDENT_PAGES;
+    if (pages > paging->num_frames || paging_available(paging) < min_pages)
+        return NOT_ASSIGNED; // could never run, or too little to start with
+
+    evict(paging, min_pages);
+    process->pages_resident = 
+            pages < paging->free_frames ? pages : paging->free_frames;
+    paging->free_frames -= process->pages_resident;
+    mark_used(paging, process);
+    return 0;
+}
+
+/* Swaps in the pages of the process that are not in frames, evicting
+   pages of the least recently used other processes as needed, and marks 
+   the process as the most recently used.
+ * The process (about to run) is pinned: its pages are not evicted until 
+   it is unpinned. Pages held by other pinned processes (running on other
+   cores) are not evicted either, so it may be left short of pages.
+ * Returns the number of pages swapped in.
+ */
+int64_t page_in(paging_t *paging, process_t *process) {
+    assert(paging && process);
+    int64_t missing = 
+            pages_needed(process->memory_requirement) - process->pages_resident;
+    // the process's own pages are not to be evicted
+    if (process->pages_resident)
+        lru_delete(paging, process);
+    // (unless the rest are pinned: alone, a process fits in memory)
+    evict(paging, missing);
+
+    if (missing > paging->free_frames)
+        missing = paging->free_frames;
+    paging->free_frames -= missing;
+    paging->page_faults += missing;
+    process->pages_resident += missing;
+    process->last_used = ++paging->clock; // (left out of the LRU index)
+    return missing;
+}
+
+/* Unpins the process (no longer running), letting its pages be evicted
+   again, as of when it was last paged in.
+ */
+void paging_unpin(paging_t *paging, process_t *process) {
+    assert(paging && process);
+    if (process->pages_resident)
+        lru_insert(paging, process);
+}
+
+/* Frees the frames held by the (possibly pinned) process.
+ */
+void paging_free(paging_t *paging, process_t *process) {
+    assert(paging && process);
+    if (!process->pages_resident)
+        return;
+    lru_delete(paging, process); // (if not pinned)
+    paging->free_frames += process->pages_resident;
+    process->pages_resident = 0;
+}
+
+/* Returns the number of frames that are free or could be freed by 
+   evicting pages (of processes not pinned).
+ */
+int64_t paging_available(paging_t *paging) {
+    assert(paging);
+    return paging->free_frames + paging->evictable_frames;
+}
+
+/* Returns the number of frames that would be available (as above) once 
+   the process's frames are freed.
+ */
+int64_t paging_available_if_freed(paging_t *paging, process_t *process) {
+    assert(paging && process);
+    int64_t available = paging_available(paging);
+    if (process->pages_resident && !avl_find(paging->lru, lru_key(process)))
+        available += process->pages_resident; // pinned: not yet counted
+    return available;
+}
+
+/* Frees all memory allocated to the virtual memory.
+ */
+void free_paging(paging_t *paging) {
+    assert(paging);
+    free_avl(paging->lru);
+    paging->lru = NULL;
+    free(paging);
+    paging = NULL;
+}
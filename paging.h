@@ -0,0 +1,83 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * paging.h :
+              = the interface of the module `paging` of the project
+              = simulates virtual memory: each process holds some of its
+                pages in frames, and pages of the least recently used
+                processes are evicted when frames run out
+ ----------------------------------------------------------------------------*/
+
+#ifndef _PAGING_H_
+#define _PAGING_H_
+
+#include <stdint.h>
+#include "process_data.h"
+#include "avl_tree.h"
+#include "bitmap.h"
+
+#define MIN_RESIDENT_PAGES 4  // pages a process is admitted with (if it has)
+
+typedef struct {
+    int64_t num_frames;       // frames of PAGE_SIZE MB
+    int64_t free_frames;      // frames are interchangeable, so only counted
+    // processes holding frames (but not running), keyed by (time last used, 0)
+    avl_tree_t *lru;
+    int64_t evictable_frames; // frames held by the processes in `lru`
+    int64_t clock;            // ticks at each use of a process
+
+    long page_faults;         // pages swapped in
+    long evictions;           // pages swapped out
+} paging_t;
+
+
+/************** function declarations **************/
+
+/* Creates and returns the virtual memory over the frames of memory of 
+   the given capacity (in MB), initially free.
+ */
+paging_t *create_paging(mem_addr_t capacity);
+
+/* Admits the process with as many of its pages as there are free frames,
+   provided that is at least MIN_RESIDENT_PAGES (or all its pages), 
+   evicting pages of the least recently used processes (not pinned) 
+   to free that many if needed.
+ * Returns the start of its (own) virtual address space, 
+   or NOT_ASSIGNED if it cannot be admitted.
+ */
+mem_addr_t paging_alloc(paging_t *paging, process_t *process);
+
+/* Swaps in the pages of the process that are not in frames, evicting
+   pages of the least recently used other processes as needed, and marks 
+   the process as the most recently used.
+ * The process (about to run) is pinned: its pages are not evicted until 
+   it is unpinned. Pages held by other pinned processes (running on other
+   cores) are not evicted either, so it may be left short of pages.
+ * Returns the number of pages swapped in.
+ */
+int64_t page_in(paging_t *paging, process_t *process);
+
+/* Unpins the process (no longer running), letting its pages be evicted
+   again, as of when it was last paged in.
+ */
+void paging_unpin(paging_t *paging, process_t *process);
+
+/* Frees the frames held by the (possibly pinned) process.
+ */
+void paging_free(paging_t *paging, process_t *process);
+
+/* Returns the number of frames that are free or could be freed by 
+   evicting pages (of processes not pinned).
+ */
+int64_t paging_available(paging_t *paging);
+
+/* Returns the number of frames that would be available (as above) once 
+   the process's frames are freed.
+ */
+int64_t paging_available_if_freed(paging_t *paging, process_t *process);
+
+/* Frees all memory allocated to the virtual memory.
+ */
+void free_paging(paging_t *paging);
+
+
+#endif
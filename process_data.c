@@ -12,20 +12,38 @@
 #include <stdint.h>
 #include "process_data.h"
 
-/* Creates and returns a process holding data read from the file `f`.
+/* some 'private' helper functions */
+static order_key_t make_order_key(process_t *process);
+
+
+/* Creates and returns a process holding data read from the (next 
+   non-blank) line of the file `f`: its arrival time, name, service time,
+   memory requirement, and optionally its weight.
  * Returns NULL if a process could not be succesfully created.
  */
 process_t *read_process(FILE *f) {
     assert(f);
-    uint32_t time_arrived, service_time;
-    int memory_requirement;
+    uint32_t time_arrived, service_time, weight = DEFAULT_WEIGHT;
+    mem_addr_t memory_requirement;
     char name[MAX_NAME_LEN+1];
-
-    if (fscanf(f, "%u %s %u %d", &time_arrived, name, &service_time, 
-            &memory_requirement) != 4) {
+    char line[MAX_LINE_LEN+1];
+
+    int values_read;
+    do {
+        if (!fgets(line, sizeof(line), f)) // no more lines
+            return NULL;
+        values_read = sscanf(line, "%u %s %u %" SCN_ADDR " %u", 
+                &time_arrived, name, &service_time, &memory_requirement, 
+                &weight);
+    } while (values_read == EOF); // a blank line
+    if (values_read < 4) {
         // incorrect number of values read
         return NULL;
     }
+    if (weight == 0) {
+        perror("Invalid weight");
+        exit(EXIT_FAILURE);
+    }
 
     /* create the process */
     process_t *process = malloc(sizeof(*process));
@@ -36,14 +54,39 @@ process_t *read_process(FILE *f) {
     strcpy(process->name, name);
     process->service_time = service_time;
     process->time_remaining = service_time;
+    process->stall_left = 0;
     process->memory_requirement = memory_requirement;
+    process->order_key = make_order_key(process);
+    process->weight = weight;
+    process->vruntime = 0;
 
     process->address_assigned = NOT_ASSIGNED;
+    process->time_loaded = 0;
+    process->bank = 0;
+    process->core = 0;
+    process->ready_order = 0;
+    process->level = 0;
     process->state = NOT_SUBMITTED;
+    process->pages_resident = 0;
+    process->last_used = 0;
 
     return process;
 }
 
+/* Helper function to pack the service time, arrival time and name of
+   the process into its order key.
+ */
+static order_key_t make_order_key(process_t *process) {
+    uint64_t name = 0;
+    int ended = 0;
+    for (int i = 0; i < MAX_NAME_LEN; i++) { // big-endian, padded with 0s
+        ended = ended || process->name[i] == '\0';
+        name = (name << 8) | (ended ? 0 : (uint8_t) process->name[i]);
+    }
+    return ((order_key_t) process->service_time << 96) 
+            | ((order_key_t) process->time_arrived << 64) | name;
+}
+
 /* Compares the arrival time of two processes.
  * Returns negative if `p1` arrived earlier, positive if `p2` arrived earlier, 
    0 otherwise.
@@ -75,6 +118,27 @@ int cmp_by_name(process_t *p1, process_t *p2) {
     return strcmp(p1->name, p2->name);
 }
 
+/* Compares two processes by their order keys: by service time, 
+   then arrival time, then name.
+ * Returns negative if `p1` orders first, positive if `p2` orders first, 
+   0 otherwise.
+ */
+int cmp_by_order_key(process_t *p1, process_t *p2) {
+    assert(p1 && p2);
+    return (p1->order_key > p2->order_key) - (p1->order_key < p2->order_key);
+}
+
+/* Compares the memory requirement of two processes.
+ * Returns negative if `p1` requires less memory, 
+   positive if `p2` requires less, 0 otherwise.
+ */
+int cmp_by_memory_requirement(process_t *p1, process_t *p2) {
+    assert(p1 && p2);
+    if (p1->memory_requirement < p2->memory_requirement) return -1;
+    if (p1->memory_requirement > p2->memory_requirement) return 1;
+    return 0;
+}
+
 /* Sets the process state as terminated.
 */
 void set_process_terminated(process_t *process, uint32_t current_sim_time) {
@@ -127,7 +191,7 @@ double get_time_overhead(process_t *process) {
 /* Prints the information about a process (for sanity checking).
 */
 void print_process(process_t *process) {
-    printf("%u %s %u %d %u\n", process->time_arrived, process->name, 
+    printf("%u %s %u %" PRI_ADDR " %u\n", process->time_arrived, process->name, 
             process->service_time, process->memory_requirement, 
             process->time_remaining);
 }
\ No newline at end of file
@@ -11,28 +11,55 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <sys/types.h>
-#include "doubly_linked_list.h"
 
 #define MAX_NAME_LEN 8    // max length of a process name
 #define HASH_LEN 64   // length of the hash from stdout of `process`
+#define MAX_LINE_LEN 256  // max length of a line of the input file
+#define DEFAULT_WEIGHT 1  // share of the CPU (under CFS), unless given
 /* On process creation */
-#define NOT_ASSIGNED NULL // no memory address assigned yet
+#define NOT_ASSIGNED -1   // no memory address assigned yet
 #define NOT_SUBMITTED -1  // process not yet submitted
 
 
-enum process_state {FINISHED, FINISHED_PROCESS, READY, RUNNING};
+enum process_state {FINISHED, FINISHED_PROCESS, READY, RUNNING, 
+        SWAPPED_OUT, SWAPPED_IN};
+
+typedef int64_t mem_addr_t;  // an address (or size) in memory, in MB
+#define PRI_ADDR PRId64      // format of a `mem_addr_t` for printf
+#define SCN_ADDR SCNd64      // format of a `mem_addr_t` for scanf
+
+/* the order of a process under SJF, packed into one integer: 
+   its service time (the top 32 bits), arrival time (the next 32 bits), 
+   and name (the low 64 bits, one byte per character, padded with 0s, 
+   so names compare as by `strcmp`) */
+typedef unsigned __int128 order_key_t;
 
 typedef struct {
     uint32_t time_arrived;
     char name[MAX_NAME_LEN+1];
     uint32_t service_time;
-    int memory_requirement;
-
-    double_node_t *address_assigned; // assigned address in memory
+    mem_addr_t memory_requirement;
+    order_key_t order_key;       // by service time, arrival time, then name
+
+    mem_addr_t address_assigned; // starting address assigned in memory
+    int bank;                    // memory bank it is (or was last) in
+    int core;                    // core it is ready (or running) on
+    uint64_t ready_order;        // when it last became ready, over all cores
+    int level;                   // priority level under MLFQ (0 the highest)
+    uint32_t weight;             // share of the CPU under CFS
+    uint64_t vruntime;           // time run under CFS, scaled by its weight
+    uint32_t time_loaded;        // when it was last allocated memory
     enum process_state state;
     uint32_t time_finished;
     uint32_t time_remaining;
+    uint64_t stall_left;         // time its core idles before it runs on
+                                 // (swapping, or paging, for it)
+
+    /* under virtual memory */
+    int64_t pages_resident;    // pages held in frames
+    int64_t last_used;         // when its pages were last used (a tick)
 
     /* to attach with the real process */
     pid_t pid;
@@ -45,7 +72,9 @@ typedef struct {
 
 /************** function declarations **************/
 
-/* Creates and returns a process holding data read from the file `f`.
+/* Creates and returns a process holding data read from the (next 
+   non-blank) line of the file `f`: its arrival time, name, service time,
+   memory requirement, and optionally its weight.
  * Returns NULL if a process could not be succesfully created.
  */
  process_t *read_process(FILE *f);
@@ -68,6 +97,19 @@ int cmp_by_service_time(process_t *p1, process_t *p2);
  */
 int cmp_by_name(process_t *p1, process_t *p2);
 
+/* Compares two processes by their order keys: by service time, 
+   then arrival time, then name.
+ * Returns negative if `p1` orders first, positive if `p2` orders first, 
+   0 otherwise.
+ */
+int cmp_by_order_key(process_t *p1, process_t *p2);
+
+/* Compares the memory requirement of two processes.
+ * Returns negative if `p1` requires less memory, 
+   positive if `p2` requires less, 0 otherwise.
+ */
+int cmp_by_memory_requirement(process_t *p1, process_t *p2);
+
 /* Sets the process state as terminated.
 */
 void set_process_terminated(process_t *process, uint32_t current_sim_time);
@@ -0,0 +1,221 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * slab.c :
+              = the implementation of the module `slab` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "slab.h"
+
+/* some 'private' helper functions */
+static avl_key_t slab_key(mem_addr_t start);
+static void link_partial(slab_class_t *class, slab_t *s);
+static void unlink_partial(slab_class_t *class, slab_t *s);
+static void record_usage(slab_class_t *class);
+
+
+/* Creates and returns a slab allocator without any slabs.
+ */
+slab_allocator_t *create_slab_allocator() {
+    slab_allocator_t *slab = malloc(sizeof(*slab));
+    assert(slab);
+    slab->num_classes = 0;
+    slab->slabs = make_empty_avl();
+    slab->size_counts = make_empty_avl();
+    return slab;
+}
+
+/* Helper function to return the key of a slab in the slab index.
+ */
+static avl_key_t slab_key(mem_addr_t start) {
+    return make_avl_key(start, 0);
+}
+
+/* Returns the class of the slabs for the size,
+   or NO_SLAB_CLASS if the size has none.
+ */
+int slab_class(slab_allocator_t *slab, mem_addr_t size) {
+    assert(slab);
+    // only a few sizes recur: a linear search is enough
+    for (int i = 0; i < slab->num_classes; i++) {
+        if (slab->classes[i].size == size)
+            return i;
+    }
+    return NO_SLAB_CLASS;
+}
+
+/* Counts an allocation of the size (which has no slabs) outside slabs,
+   giving the size slabs from now on once it recurs.
+ */
+void slab_count_size(slab_allocator_t *slab, mem_addr_t size) {
+    assert(slab && slab_class(slab, size) == NO_SLAB_CLASS);
+    if (slab->num_classes == MAX_SLAB_CLASSES) // no classes left
+        return;
+
+    avl_node_t *node = avl_find(slab->size_counts, make_avl_key(size, 0));
+    if (!node) {
+        avl_insert(slab->size_counts, make_avl_key(size, 0), (void *) 1);
+        node = avl_find(slab->size_counts, make_avl_key(size, 0));
+    } else { // the count is held in place of the data
+        node->data = (void *) ((intptr_t) node->data + 1);
+    }
+    if ((intptr_t) node->data < SLAB_MIN_ALLOCS)
+        return;
+
+    // the size recurs: give it slabs
+    avl_delete(slab->size_counts, make_avl_key(size, 0));
+    slab_class_t *class = &slab->classes[slab->num_classes++];
+    class->size = size;
+    class->partial = NULL;
+    class->num_slabs = 0;
+    class->slots = class->slots_used = 0;
+    class->num_allocs = 0;
+    class->max_slots = class->max_slots_used = 0;
+    class->max_waste = 0;
+}
+
+/* Helper function to add the slab to the front of the class's list of
+   partial slabs.
+ */
+static void link_partial(slab_class_t *class, slab_t *s) {
+    s->prev = NULL;
+    s->next = class->partial;
+    if (class->partial)
+        class->partial->prev = s;
+    class->partial = s;
+}
+
+/* Helper function to remove the slab from the class's list of
+   partial slabs.
+ */
+static void unlink_partial(slab_class_t *class, slab_t *s) {
+    if (s->prev)
+        s->prev->next = s->next;
+    else
+        class->partial = s->next;
+    if (s->next)
+        s->next->prev = s->prev;
+    s->prev = s->next = NULL;
+}
+
+/* Helper function to update the peak usage of the class.
+ */
+static void record_usage(slab_class_t *class) {
+    if (class->slots > class->max_slots)
+        class->max_slots = class->slots;
+    if (class->slots_used > class->max_slots_used)
+        class->max_slots_used = class->slots_used;
+    mem_addr_t waste = (class->slots - class->slots_used) * class->size;
+    if (waste > class->max_waste)
+        class->max_waste = waste;
+}
+
+/* Takes a free slot from a slab of the class.
+ * Returns its address, or NOT_ASSIGNED if the class has no free slot.
+ */
+mem_addr_t slab_alloc(slab_allocator_t *slab, int size_class) {
+    assert(slab && size_class >= 0 && size_class < slab->num_classes);
+    slab_class_t *class = &slab->classes[size_class];
+    slab_t *s = class->partial;
+    if (!s)
+        return NOT_ASSIGNED;
+
+    int slot = s->free_slots[--s->num_free];
+    if (!s->num_free) // full
+        unlink_partial(class, s);
+    class->slots_used++;
+    class->num_allocs++;
+    record_usage(class);
+    return s->start + slot * class->size;
+}
+
+/* Adds a slab of the class, over the region starting at the address,
+   holding the given number of (free) slots.
+ */
+void slab_add(slab_allocator_t *slab, int size_class, mem_addr_t start,
+        int num_slots) {
+    assert(slab && size_class >= 0 && size_class < slab->num_classes);
+    assert(num_slots > 0 && num_slots <= SLAB_SLOTS);
+    slab_class_t *class = &slab->classes[size_class];
+    slab_t *s = malloc(sizeof(*s));
+    assert(s);
+    s->start = start;
+    s->size_class = size_class;
+    s->num_slots = s->num_free = num_slots;
+    for (int i = 0; i < num_slots; i++) // lowest address on top
+        s->free_slots[i] = num_slots - 1 - i;
+
+    avl_insert(slab->slabs, slab_key(start), s);
+    link_partial(class, s);
+    class->num_slabs++;
+    class->slots += num_slots;
+    record_usage(class);
+}
+
+/* Returns the slot at the address to its slab, if it is in a slab.
+ * If that leaves the slab empty, the slab is removed, and the start and
+   length of its region are stored in the corresponding pointers.
+ * Returns FALSE (0) if the address is in no slab, TRUE (1) otherwise.
+ */
+int slab_free(slab_allocator_t *slab, mem_addr_t address,
+        mem_addr_t *released_start, mem_addr_t *released_length) {
+    assert(slab && released_start && released_length);
+    *released_start = NOT_ASSIGNED;
+    *released_length = 0;
+
+    avl_node_t *node = avl_floor(slab->slabs, slab_key(address));
+    if (!node)
+        return 0;
+    slab_t *s = node->data;
+    slab_class_t *class = &slab->classes[s->size_class];
+    if (address >= s->start + s->num_slots * class->size)
+        return 0; // past the end of the nearest slab
+
+    s->free_slots[s->num_free++] = (address - s->start) / class->size;
+    if (s->num_free == 1) // was full
+        link_partial(class, s);
+    class->slots_used--;
+    record_usage(class);
+
+    if (s->num_free == s->num_slots) { // empty: give the region back
+        unlink_partial(class, s);
+        avl_delete(slab->slabs, slab_key(s->start));
+        class->num_slabs--;
+        class->slots -= s->num_slots;
+        *released_start = s->start;
+        *released_length = s->num_slots * class->size;
+        free(s);
+        s = NULL;
+    }
+    return 1;
+}
+
+/* Returns the largest size with a free slot (0 if none).
+ */
+mem_addr_t slab_largest_free(slab_allocator_t *slab) {
+    assert(slab);
+    mem_addr_t largest = 0;
+    for (int i = 0; i < slab->num_classes; i++) {
+        if (slab->classes[i].partial && slab->classes[i].size > largest)
+            largest = slab->classes[i].size;
+    }
+    return largest;
+}
+
+/* Frees all memory allocated to the slab allocator.
+ */
+void free_slab_allocator(slab_allocator_t *slab) {
+    assert(slab);
+    // the slabs are owned by the allocator
+    avl_node_t *node;
+    while ((node = avl_min(slab->slabs)))
+        free(avl_delete(slab->slabs, node->key));
+    free_avl(slab->slabs);
+    slab->slabs = NULL;
+    free_avl(slab->size_counts);
+    slab->size_counts = NULL;
+    free(slab);
+    slab = NULL;
+}
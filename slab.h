@@ -0,0 +1,102 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * slab.h :
+              = the interface of the module `slab` of the project
+              = keeps track of slabs: regions of segment memory reserved
+                for a recurring size of process, carved into slots of that
+                size, each on a list of free slots
+ ----------------------------------------------------------------------------*/
+
+#ifndef _SLAB_H_
+#define _SLAB_H_
+
+#include <stdint.h>
+#include "process_data.h"
+#include "avl_tree.h"
+
+#define MAX_SLAB_CLASSES 16  // most sizes given slabs
+#define SLAB_SLOTS 8         // most slots in a slab
+#define SLAB_MIN_ALLOCS 2    // allocations of a size before it gets slabs
+#define NO_SLAB_CLASS -1     // a size without slabs
+
+typedef struct slab slab_t;
+
+struct slab {
+    mem_addr_t start;        // start of the region
+    int size_class;
+    int num_slots;
+    int num_free;
+    int free_slots[SLAB_SLOTS]; // stack of the free slots' indices
+    slab_t *prev;            // neighbours in the list of partial slabs
+    slab_t *next;
+};
+
+/* the slabs for a size */
+typedef struct {
+    mem_addr_t size;
+    slab_t *partial;         // slabs with a free slot
+    int num_slabs;
+    int64_t slots;           // slots in all slabs
+    int64_t slots_used;
+
+    // for statistics
+    long num_allocs;
+    int64_t max_slots;
+    int64_t max_slots_used;
+    mem_addr_t max_waste;    // most memory in free slots at once
+} slab_class_t;
+
+typedef struct {
+    slab_class_t classes[MAX_SLAB_CLASSES];
+    int num_classes;
+    avl_tree_t *slabs;       // all slabs, keyed by (start, 0)
+    // allocations of the sizes without slabs, keyed by (size, 0)
+    avl_tree_t *size_counts;
+} slab_allocator_t;
+
+
+/************** function declarations **************/
+
+/* Creates and returns a slab allocator without any slabs.
+ */
+slab_allocator_t *create_slab_allocator();
+
+/* Returns the class of the slabs for the size,
+   or NO_SLAB_CLASS if the size has none.
+ */
+int slab_class(slab_allocator_t *slab, mem_addr_t size);
+
+/* Counts an allocation of the size (which has no slabs) outside slabs,
+   giving the size slabs from now on once it recurs.
+ */
+void slab_count_size(slab_allocator_t *slab, mem_addr_t size);
+
+/* Takes a free slot from a slab of the class.
+ * Returns its address, or NOT_ASSIGNED if the class has no free slot.
+ */
+mem_addr_t slab_alloc(slab_allocator_t *slab, int size_class);
+
+/* Adds a slab of the class, over the region starting at the address,
+   holding the given number of (free) slots.
+ */
+void slab_add(slab_allocator_t *slab, int size_class, mem_addr_t start,
+        int num_slots);
+
+/* Returns the slot at the address to its slab, if it is in a slab.
+ * If that leaves the slab empty, the slab is removed, and the start and
+   length of its region are stored in the corresponding pointers.
+ * Returns FALSE (0) if the address is in no slab, TRUE (1) otherwise.
+ */
+int slab_free(slab_allocator_t *slab, mem_addr_t address,
+        mem_addr_t *released_start, mem_addr_t *released_length);
+
+/* Returns the largest size with a free slot (0 if none).
+ */
+mem_addr_t slab_largest_free(slab_allocator_t *slab);
+
+/* Frees all memory allocated to the slab allocator.
+ */
+void free_slab_allocator(slab_allocator_t *slab);
+
+
+#endif
@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * tlsf.c :
+              = the implementation of the module `tlsf` of the project
+ ----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <assert.h>
+#include "tlsf.h"
+
+#define TLSF_SMALL_SIZE TLSF_SL_COUNT  // sizes below are classed linearly
+
+/* some 'private' helper functions */
+static int msb(mem_addr_t size);
+static void mapping(mem_addr_t size, int *fl, int *sl);
+static avl_key_t hole_key(mem_addr_t start, mem_addr_t length);
+static mem_addr_t find_in_class(tlsf_t *tlsf, int fl, int sl,
+        mem_addr_t size);
+
+
+/* Creates and returns an empty TLSF index.
+ */
+tlsf_t *create_tlsf() {
+    tlsf_t *tlsf = malloc(sizeof(*tlsf));
+    assert(tlsf);
+    tlsf->fl_bitmap = 0;
+    for (int f = 0; f < TLSF_FL_COUNT; f++) {
+        tlsf->sl_bitmap[f] = 0;
+        for (int s = 0; s < TLSF_SL_COUNT; s++)
+            tlsf->free_lists[f][s] = NULL;
+    }
+    return tlsf;
+}
+
+/* Helper function to return the index of the most significant bit set.
+ */
+static int msb(mem_addr_t size) {
+    return 63 - __builtin_clzll(size);
+}
+
+/* Helper function to compute the class (`fl`, `sl`) of the size: 
+   sizes in [2^f, 2^(f+1)) are split into TLSF_SL_COUNT equal ranges.
+ */
+static void mapping(mem_addr_t size, int *fl, int *sl) {
+    if (size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = size;
+        return;
+    }
+    int f = msb(size);
+    *sl = (size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+    *fl = f - TLSF_SL_LOG2 + 1;
+}
+
+/* Helper function to return the key of a hole in its free list.
+ */
+static avl_key_t hole_key(mem_addr_t start, mem_addr_t length) {
+    return make_avl_key(length, start);
+}
+
+/* Adds the hole starting at the address, of the given length, to the index.
+ */
+void tlsf_insert(tlsf_t *tlsf, mem_addr_t start, mem_addr_t length) {
+    assert(tlsf && length > 0);
+    int fl, sl;
+    mapping(length, &fl, &sl);
+    if (!tlsf->free_lists[fl][sl])
+        tlsf->free_lists[fl][sl] = make_empty_avl();
+
+    avl_insert(tlsf->free_lists[fl][sl], hole_key(start, length), NULL);
+    tlsf->fl_bitmap |= (uint64_t) 1 << fl;
+    tlsf->sl_bitmap[fl] |= (uint32_t) 1 << sl;
+}
+
+/* Removes the hole starting at the address, of the given length, 
+   from the index.
+ */
+void tlsf_remove(tlsf_t *tlsf, mem_addr_t start, mem_addr_t length) {
+    assert(tlsf && length > 0);
+    int fl, sl;
+    mapping(length, &fl, &sl);
+    avl_tree_t *list = tlsf->free_lists[fl][sl];
+    assert(list && avl_find(list, hole_key(start, length)));
+
+    avl_delete(list, hole_key(start, length));
+    if (is_empty_avl(list)) {
+        tlsf->sl_bitmap[fl] &= ~((uint32_t) 1 << sl);
+        if (!tlsf->sl_bitmap[fl])
+            tlsf->fl_bitmap &= ~((uint64_t) 1 << fl);
+    }
+}
+
+/* Returns the start of a hole holding the given size: the smallest hole
+   (the lowest-addressed on ties) of the smallest non-empty class whose
+   holes all hold the size, or else the smallest hole holding it in the
+   size's own class.
+ * Returns NOT_ASSIGNED if there is none.
+ */
+mem_addr_t tlsf_find(tlsf_t *tlsf, mem_addr_t size) {
+    assert(tlsf && size > 0);
+    int own_fl, own_sl;
+    mapping(size, &own_fl, &own_sl);
+    // round the size up to the next class boundary, so any hole fits
+    mem_addr_t rounded = size;
+    if (size >= TLSF_SMALL_SIZE)
+        rounded += ((mem_addr_t) 1 << (msb(size) - TLSF_SL_LOG2)) - 1;
+    int fl, sl;
+    mapping(rounded, &fl, &sl);
+
+    // a class of the same power of two, or else a higher power of two
+    uint32_t sl_map = tlsf->sl_bitmap[fl] & (~(uint32_t) 0 << sl);
+    if (!sl_map) {
+        uint64_t fl_map = fl + 1 < TLSF_FL_COUNT 
+                ? tlsf->fl_bitmap & (~(uint64_t) 0 << (fl + 1)) : 0;
+        if (!fl_map) // only a hole of the size's own class may hold it
+            return find_in_class(tlsf, own_fl, own_sl, size);
+        fl = __builtin_ctzll(fl_map);
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+    sl = __builtin_ctz(sl_map);
+
+    return avl_min(tlsf->free_lists[fl][sl])->key.secondary;
+}
+
+/* Helper function to return the start of the smallest hole of the class
+   (`fl`, `sl`) holding the size, or NOT_ASSIGNED if none does.
+ */
+static mem_addr_t find_in_class(tlsf_t *tlsf, int fl, int sl,
+        mem_addr_t size) {
+    if (!(tlsf->sl_bitmap[fl] & ((uint32_t) 1 << sl))) // empty class
+        return NOT_ASSIGNED;
+    avl_node_t *hole =
+            avl_lower_bound(tlsf->free_lists[fl][sl], hole_key(0, size));
+    return hole ? hole->key.secondary : NOT_ASSIGNED;
+}
+
+/* Frees all memory allocated to the index.
+ */
+void free_tlsf(tlsf_t *tlsf) {
+    assert(tlsf);
+    for (int f = 0; f < TLSF_FL_COUNT; f++) {
+        for (int s = 0; s < TLSF_SL_COUNT; s++) {
+            if (tlsf->free_lists[f][s])
+                free_avl(tlsf->free_lists[f][s]);
+        }
+    }
+    free(tlsf);
+    tlsf = NULL;
+}
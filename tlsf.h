@@ -0,0 +1,58 @@
+/*-----------------------------------------------------------------------------
+ * Project 1
+ * tlsf.h :
+              = the interface of the module `tlsf` of the project
+              = indexes the holes of segment memory by two-level segregated
+                fit (TLSF): size classes split first by power of two, then
+                linearly, with bitmaps marking the non-empty classes
+ ----------------------------------------------------------------------------*/
+
+#ifndef _TLSF_H_
+#define _TLSF_H_
+
+#include <stdint.h>
+#include "process_data.h"
+#include "avl_tree.h"
+
+#define TLSF_SL_LOG2 4                      // log2 of the second-level count
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)   // classes per power of two
+#define TLSF_FL_COUNT 64                    // first-level classes
+
+typedef struct {
+    uint64_t fl_bitmap;                     // bit f set if class f is used
+    uint32_t sl_bitmap[TLSF_FL_COUNT];      // bit s set if list (f, s) is
+    // holes in each size class, keyed by (length, start) (so each operation
+    // is O(log n), not O(1)); created when needed
+    avl_tree_t *free_lists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+} tlsf_t;
+
+
+/************** function declarations **************/
+
+/* Creates and returns an empty TLSF index.
+ */
+tlsf_t *create_tlsf();
+
+/* Adds the hole starting at the address, of the given length, to the index.
+ */
+void tlsf_insert(tlsf_t *tlsf, mem_addr_t start, mem_addr_t length);
+
+/* Removes the hole starting at the address, of the given length, 
+   from the index.
+ */
+void tlsf_remove(tlsf_t *tlsf, mem_addr_t start, mem_addr_t length);
+
+/* Returns the start of a hole holding the given size: the smallest hole
+   (the lowest-addressed on ties) of the smallest non-empty class whose
+   holes all hold the size, or else the smallest hole holding it in the
+   size's own class.
+ * Returns NOT_ASSIGNED if there is none.
+ */
+mem_addr_t tlsf_find(tlsf_t *tlsf, mem_addr_t size);
+
+/* Frees all memory allocated to the index.
+ */
+void free_tlsf(tlsf_t *tlsf);
+
+
+#endif